@@ -0,0 +1,442 @@
+// Banco de pruebas de rendimiento: resuelve cada instancia de un directorio con semilla,
+// p y alpha fijos y registra iteraciones/s, tasa de aceptación, tiempo hasta la energía
+// objetivo, energía final y pico de memoria (RSS). Con --baseline compara contra una
+// corrida guardada: una energía final peor (determinista con la semilla fija) es una
+// regresión (código de salida 2); iteraciones/s, tiempo al objetivo y memoria dependen de
+// la máquina y del ruido entre corridas, así que solo se avisan salvo con --strict (línea
+// base generada en la misma máquina, dedicada a medir). Con --dp-stride también
+// resuelve cada instancia con la programación dinámica (óptimo guillotina) y reporta la
+// brecha de la energía final de SA respecto de ese óptimo.
+//
+//   ./bin/spp_bench --p 6 --alpha 0.5 --seed 12345 --baseline bench/baseline.json
+//   ./bin/spp_bench ... --out bench/baseline.json        (regenera la línea base)
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "GuillotineDP.hpp"
+#include "IO.hpp"
+#include "Random.hpp"
+#include "SA.hpp"
+#include "third_party/json.hpp"
+
+namespace
+{
+    using json = nlohmann::json;
+
+    struct BenchOptions
+    {
+        std::string instancesDir = "data/instances";
+        std::string configPath = "data/config/default.json";
+        std::string baselinePath;
+        std::string outPath;
+        std::string format = "json"; // "json" o "csv"
+        int p = 6;
+        double alpha = 0.5;
+        unsigned long long seed = 12345;
+        int itersPerTemp = 5000;
+        int iterations = 2000000;
+        int repeat = 3;                 // se reporta la mediana de las repeticiones
+        bool strict = false;            // las regresiones de tiempo y memoria también fallan
+        double maxSeconds = 60.0;
+        double tolerance = 0.20;        // margen relativo para rendimiento y memoria
+        double timeSlack = 0.01;        // margen absoluto (s) para el tiempo al objetivo
+        double energyTolerance = 0.001; // margen relativo para la energía final
+        int dpStride = 0;               // paso de corte de la referencia por DP; 0 = sin referencia
+    };
+
+    struct BenchResult
+    {
+        std::string instance;
+        int rows = 0;
+        int cols = 0;
+        long long iterations = 0;
+        double seconds = 0.0;
+        double iterationsPerSecond = 0.0;
+        double acceptanceRate = 0.0;
+        double finalEnergy = 0.0;
+        double targetEnergy = -1.0;
+        double timeToTarget = -1.0;
+        long peakRssKb = 0;
+        double dpEnergy = -1.0; // óptimo guillotina (DP); -1 = no calculado
+        double dpGap = -1.0;    // (final_energy - dp_energy) / dp_energy
+    };
+
+    void printUsage(const char *program)
+    {
+        std::cout << "Uso: " << program << " [opciones]\n"
+                  << "  --instances DIR        directorio de instancias (data/instances)\n"
+                  << "  --config PATH          configuración base de SA (data/config/default.json)\n"
+                  << "  --p N --alpha A        parámetros fijos del problema (6, 0.5)\n"
+                  << "  --seed S               semilla fija (12345)\n"
+                  << "  --iters-per-temp N     iteraciones por temperatura (5000)\n"
+                  << "  --iterations N         iteraciones por instancia (2000000)\n"
+                  << "  --repeat N             repeticiones por instancia; se toma la mediana (3)\n"
+                  << "  --max-seconds T        tope de tiempo por instancia (60)\n"
+                  << "  --baseline PATH        comparar contra una corrida guardada\n"
+                  << "  --tolerance X          margen relativo de rendimiento/memoria (0.20)\n"
+                  << "  --energy-tolerance X   margen relativo de energía final (0.001)\n"
+                  << "  --strict               fallar también por iteraciones/s, tiempo al objetivo o memoria\n"
+                  << "  --dp-stride S          referencia exacta por DP con paso de corte S (0 = sin referencia)\n"
+                  << "  --format json|csv      formato de --out (json)\n"
+                  << "  --out PATH             escribir resultados (json se puede usar como línea base)\n";
+    }
+
+    BenchOptions parseArgs(int argc, char *argv[])
+    {
+        BenchOptions opts;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                printUsage(argv[0]);
+                std::exit(0);
+            }
+            if (arg == "--strict")
+            {
+                opts.strict = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Falta el valor de " + arg);
+            }
+            const std::string value = argv[++i];
+            if (arg == "--instances")
+                opts.instancesDir = value;
+            else if (arg == "--config")
+                opts.configPath = value;
+            else if (arg == "--baseline")
+                opts.baselinePath = value;
+            else if (arg == "--out")
+                opts.outPath = value;
+            else if (arg == "--format")
+                opts.format = value;
+            else if (arg == "--p")
+                opts.p = std::stoi(value);
+            else if (arg == "--alpha")
+                opts.alpha = std::stod(value);
+            else if (arg == "--seed")
+                opts.seed = std::stoull(value);
+            else if (arg == "--iters-per-temp")
+                opts.itersPerTemp = std::stoi(value);
+            else if (arg == "--iterations")
+                opts.iterations = std::stoi(value);
+            else if (arg == "--repeat")
+                opts.repeat = std::max(1, std::stoi(value));
+            else if (arg == "--max-seconds")
+                opts.maxSeconds = std::stod(value);
+            else if (arg == "--tolerance")
+                opts.tolerance = std::stod(value);
+            else if (arg == "--energy-tolerance")
+                opts.energyTolerance = std::stod(value);
+            else if (arg == "--dp-stride")
+                opts.dpStride = std::max(0, std::stoi(value));
+            else
+                throw std::runtime_error("Opcion desconocida: " + arg);
+        }
+        if (opts.format != "json" && opts.format != "csv")
+        {
+            throw std::runtime_error("Formato desconocido: " + opts.format + " (use json o csv)");
+        }
+        return opts;
+    }
+
+    // Pico de memoria residente del proceso (KB en Linux). Las instancias se resuelven en
+    // orden de tamaño, así que el pico acumulado corresponde a la mayor hasta el momento.
+    long peakRssKb()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    json toJson(const BenchResult &r)
+    {
+        json doc{{"instance", r.instance},
+                 {"rows", r.rows},
+                 {"cols", r.cols},
+                 {"iterations", r.iterations},
+                 {"seconds", r.seconds},
+                 {"iterations_per_second", r.iterationsPerSecond},
+                 {"acceptance_rate", r.acceptanceRate},
+                 {"final_energy", r.finalEnergy},
+                 {"target_energy", r.targetEnergy},
+                 {"time_to_target_seconds", r.timeToTarget},
+                 {"peak_rss_kb", r.peakRssKb}};
+        if (r.dpEnergy >= 0.0)
+        {
+            doc["dp_energy"] = r.dpEnergy;
+            doc["dp_gap"] = r.dpGap;
+        }
+        return doc;
+    }
+
+    void writeResults(const BenchOptions &opts, const std::vector<BenchResult> &results)
+    {
+        std::ofstream out(opts.outPath);
+        if (!out)
+        {
+            throw std::runtime_error("No se pudo abrir el archivo de resultados: " + opts.outPath);
+        }
+        if (opts.format == "csv")
+        {
+            out << std::setprecision(10);
+            out << "instance,rows,cols,iterations,seconds,iterations_per_second,acceptance_rate,final_energy,target_energy,time_to_target_seconds,peak_rss_kb,dp_energy,dp_gap\n";
+            for (const BenchResult &r : results)
+            {
+                out << r.instance << ',' << r.rows << ',' << r.cols << ',' << r.iterations << ','
+                    << r.seconds << ',' << r.iterationsPerSecond << ',' << r.acceptanceRate << ','
+                    << r.finalEnergy << ',' << r.targetEnergy << ',' << r.timeToTarget << ',' << r.peakRssKb << ','
+                    << r.dpEnergy << ',' << r.dpGap << '\n';
+            }
+            return;
+        }
+
+        json doc;
+        doc["params"] = {{"p", opts.p}, {"alpha", opts.alpha}, {"seed", opts.seed}, {"iters_per_temp", opts.itersPerTemp}, {"iterations", opts.iterations}, {"repeat", opts.repeat}, {"config", opts.configPath}};
+        doc["results"] = json::array();
+        for (const BenchResult &r : results)
+        {
+            doc["results"].push_back(toJson(r));
+        }
+        out << std::setw(2) << doc << '\n';
+    }
+
+    std::map<std::string, json> readBaseline(const std::string &path)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            throw std::runtime_error("No se pudo abrir la linea base: " + path);
+        }
+        json doc;
+        in >> doc;
+        std::map<std::string, json> byInstance;
+        for (const json &r : doc.at("results"))
+        {
+            byInstance[r.at("instance").get<std::string>()] = r;
+        }
+        return byInstance;
+    }
+
+    // Compara una métrica contra la línea base; 'higherIsBetter' indica el sentido de la regresión.
+    bool regressed(double current, double base, double tolerance, bool higherIsBetter)
+    {
+        if (higherIsBetter)
+        {
+            return current < base * (1.0 - tolerance);
+        }
+        return current > base * (1.0 + tolerance) + 1e-9;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const BenchOptions opts = parseArgs(argc, argv);
+
+        SAConfig cfg = IO::readConfigFromJson(opts.configPath);
+        cfg.seed = opts.seed;
+        cfg.chains = 1;
+        cfg.itersPerTemp = opts.itersPerTemp;
+        cfg.maxIterations = opts.iterations;
+        cfg.maxTimeSeconds = opts.maxSeconds;
+        // Programa y recalentamiento que no dependen del reloj: con la semilla fija la
+        // trayectoria (y por tanto la energía final) es la misma en cada corrida.
+        cfg.schedule = "geometric";
+        cfg.reheatStagnation = 0.0;
+        cfg.totalTimeSeconds = 0.0;
+
+        std::vector<std::string> paths;
+        for (const auto &entry : std::filesystem::directory_iterator(opts.instancesDir))
+        {
+            const std::string ext = entry.path().extension().string();
+            if (entry.is_regular_file() && (ext == ".spp" || ext == ".sppb"))
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+
+        std::vector<ProblemInstance> instances;
+        for (const std::string &path : paths)
+        {
+            instances.push_back(IO::readInstanceFromFile(path));
+        }
+        // De menor a mayor, para que el pico de RSS acumulado sea significativo por instancia.
+        std::vector<size_t> order(paths.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                  {
+                      const long long areaA = static_cast<long long>(instances[a].nRows) * instances[a].nCols;
+                      const long long areaB = static_cast<long long>(instances[b].nRows) * instances[b].nCols;
+                      return areaA != areaB ? areaA < areaB : paths[a] < paths[b]; });
+
+        std::map<std::string, json> baseline;
+        if (!opts.baselinePath.empty())
+        {
+            baseline = readBaseline(opts.baselinePath);
+        }
+
+        std::vector<BenchResult> results;
+        int regressions = 0;
+        std::cout << std::left << std::setw(14) << "instancia" << std::right << std::setw(12) << "iter/s"
+                  << std::setw(10) << "acept." << std::setw(14) << "energia" << std::setw(12) << "t_obj (s)"
+                  << std::setw(12) << "RSS (KB)" << '\n';
+
+        for (size_t idx : order)
+        {
+            ProblemInstance &instance = instances[idx];
+            instance.p = opts.p;
+            instance.alpha = opts.alpha;
+
+            BenchResult r;
+            r.instance = std::filesystem::path(paths[idx]).stem().string();
+            r.rows = instance.nRows;
+            r.cols = instance.nCols;
+
+            // Tiempo hasta alcanzar la energía final de la línea base (misma semilla => misma trayectoria).
+            // Sin línea base (p.ej. al regenerarla) el objetivo es la energía final de una pasada
+            // previa sin medir, para que la línea base también registre un tiempo al objetivo.
+            SAConfig runCfg = cfg;
+            const auto base = baseline.find(r.instance);
+            double targetBase = 0.0;
+            if (base != baseline.end())
+            {
+                targetBase = base->second.at("final_energy").get<double>();
+            }
+            else
+            {
+                Rng rng = makeChainRng(runCfg, 0);
+                SAStats calibration;
+                simulatedAnnealing(instance, runCfg, rng, nullptr, &calibration);
+                targetBase = calibration.bestEnergy;
+            }
+            runCfg.targetEnergy = targetBase * (1.0 + opts.energyTolerance);
+            r.targetEnergy = runCfg.targetEnergy;
+
+            // Misma semilla en cada repetición: la trayectoria no cambia, solo el tiempo medido.
+            // Se reporta la repetición de tiempo mediano y la mediana del tiempo al objetivo.
+            std::vector<SAStats> reps(opts.repeat);
+            std::vector<double> targetTimes;
+            for (SAStats &repStats : reps)
+            {
+                Rng rng = makeChainRng(runCfg, 0);
+                simulatedAnnealing(instance, runCfg, rng, nullptr, &repStats);
+                targetTimes.push_back(repStats.timeToTarget);
+            }
+            std::sort(reps.begin(), reps.end(), [](const SAStats &a, const SAStats &b)
+                      { return a.elapsedSeconds < b.elapsedSeconds; });
+            std::sort(targetTimes.begin(), targetTimes.end());
+            SAStats stats = reps[reps.size() / 2];
+            stats.timeToTarget = targetTimes[targetTimes.size() / 2];
+
+            r.iterations = stats.iterations;
+            r.seconds = stats.elapsedSeconds;
+            r.iterationsPerSecond = stats.elapsedSeconds > 0.0 ? static_cast<double>(stats.iterations) / stats.elapsedSeconds : 0.0;
+            r.acceptanceRate = stats.iterations > 0 ? static_cast<double>(stats.accepted) / static_cast<double>(stats.iterations) : 0.0;
+            r.finalEnergy = stats.bestEnergy;
+            r.timeToTarget = stats.timeToTarget;
+            r.peakRssKb = peakRssKb();
+
+            // Referencia: óptimo entre las particiones guillotina (después de medir la memoria de SA).
+            if (opts.dpStride > 0)
+            {
+                SAConfig dpCfg = cfg;
+                dpCfg.dpCutStride = opts.dpStride;
+                try
+                {
+                    DPStats dp;
+                    guillotineDP(instance, dpCfg, nullptr, nullptr, &dp);
+                    r.dpEnergy = dp.energy;
+                    r.dpGap = dp.energy > 0.0 ? (r.finalEnergy - dp.energy) / dp.energy : 0.0;
+                }
+                catch (const std::runtime_error &ex)
+                {
+                    std::cout << "   DP omitida en " << r.instance << ": " << ex.what() << '\n';
+                }
+            }
+            results.push_back(r);
+
+            std::cout << std::left << std::setw(14) << r.instance << std::right << std::setw(12) << static_cast<long long>(r.iterationsPerSecond)
+                      << std::setw(10) << std::setprecision(3) << r.acceptanceRate << std::setw(14) << std::setprecision(8) << r.finalEnergy
+                      << std::setw(12) << std::setprecision(3) << r.timeToTarget << std::setw(12) << r.peakRssKb << '\n';
+            if (r.dpEnergy >= 0.0)
+            {
+                std::cout << "   optimo guillotina (DP): " << std::setprecision(8) << r.dpEnergy
+                          << ", brecha de SA " << std::setprecision(3) << 100.0 * r.dpGap << " %\n";
+            }
+
+            if (base == baseline.end())
+            {
+                continue;
+            }
+            const json &b = base->second;
+            std::vector<std::string> flags;    // fallan siempre
+            std::vector<std::string> warnings; // fallan solo con --strict
+            if (regressed(r.finalEnergy, b.at("final_energy").get<double>(), opts.energyTolerance, false))
+            {
+                flags.push_back("energia final");
+            }
+            if (regressed(r.iterationsPerSecond, b.at("iterations_per_second").get<double>(), opts.tolerance, true))
+            {
+                warnings.push_back("iteraciones/s");
+            }
+            const double baseTime = b.at("time_to_target_seconds").get<double>();
+            if (baseTime >= 0.0 && (r.timeToTarget < 0.0 || regressed(r.timeToTarget, baseTime + opts.timeSlack, opts.tolerance, false)))
+            {
+                warnings.push_back("tiempo al objetivo");
+            }
+            if (regressed(static_cast<double>(r.peakRssKb), b.at("peak_rss_kb").get<double>(), opts.tolerance, false))
+            {
+                warnings.push_back("memoria");
+            }
+            if (opts.strict)
+            {
+                flags.insert(flags.end(), warnings.begin(), warnings.end());
+                warnings.clear();
+            }
+            for (const std::string &flag : flags)
+            {
+                std::cout << "   REGRESION en " << r.instance << ": " << flag << '\n';
+                ++regressions;
+            }
+            for (const std::string &warning : warnings)
+            {
+                std::cout << "   AVISO en " << r.instance << ": " << warning << " (depende de la maquina; --strict para fallar)\n";
+            }
+        }
+
+        if (!opts.outPath.empty())
+        {
+            writeResults(opts, results);
+            std::cout << "Resultados: " << opts.outPath << '\n';
+        }
+        if (!baseline.empty())
+        {
+            std::cout << (regressions == 0 ? "Sin regresiones respecto de " : std::to_string(regressions) + " regresion(es) respecto de ")
+                      << opts.baselinePath << '\n';
+        }
+        return regressions == 0 ? 0 : 2;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << '\n';
+        return 1;
+    }
+}
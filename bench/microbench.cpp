@@ -0,0 +1,365 @@
+// Microbenchmarks de las primitivas de Solution.cpp sobre grillas sintéticas de tamaño y
+// p variables (mucho mayores que las instancias de data/instances). Para cada primitiva
+// informa ns/op y asignaciones de memoria por operación, para ver cómo escala con N·M y p.
+// También mide AnnealingChain::step, que no debe reservar memoria una vez en régimen: si
+// tras el calentamiento hace alguna asignación, el programa termina con código 3.
+//
+//   ./bin/spp_microbench [--sizes 64,256,1024,2048] [--p 4,16,64] [--min-time 0.2]
+//                        [--filter texto] [--csv archivo.csv]
+//
+// El número de repeticiones de cada caso se calibra hasta superar --min-time segundos.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AnnealingChain.hpp"
+#include "IntegralImage.hpp"
+#include "Random.hpp"
+#include "Schedule.hpp"
+#include "Solution.hpp"
+
+// ---------------------------------------------------------------------------
+// Conteo de asignaciones: se reemplazan los operadores new/delete globales y
+// aligned_alloc (que usa Grid) para contar llamadas y bytes pedidos.
+// ---------------------------------------------------------------------------
+namespace
+{
+    std::atomic<long long> allocCount{0};
+    std::atomic<long long> allocBytes{0};
+
+    void *countedAlloc(std::size_t n)
+    {
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+        allocBytes.fetch_add(static_cast<long long>(n), std::memory_order_relaxed);
+        if (void *p = std::malloc(n ? n : 1))
+        {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void *countedAlignedAlloc(std::size_t alignment, std::size_t n)
+    {
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+        allocBytes.fetch_add(static_cast<long long>(n), std::memory_order_relaxed);
+        void *p = nullptr;
+        if (posix_memalign(&p, alignment < sizeof(void *) ? sizeof(void *) : alignment, n ? n : 1) != 0)
+        {
+            return nullptr;
+        }
+        return p;
+    }
+}
+
+void *operator new(std::size_t n) { return countedAlloc(n); }
+void *operator new[](std::size_t n) { return countedAlloc(n); }
+void *operator new(std::size_t n, std::align_val_t a)
+{
+    if (void *p = countedAlignedAlloc(static_cast<std::size_t>(a), n))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t n, std::align_val_t a) { return operator new(n, a); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Grid reserva con std::aligned_alloc; la definición del ejecutable tiene prioridad sobre la de libc.
+extern "C" void *aligned_alloc(std::size_t alignment, std::size_t n)
+{
+    return countedAlignedAlloc(alignment, n);
+}
+
+namespace
+{
+    // Evita que el compilador descarte el resultado de la operación medida.
+    volatile double sink = 0.0;
+
+    struct MicroOptions
+    {
+        std::vector<int> sizes = {64, 256, 1024, 2048};
+        std::vector<int> ps = {4, 16, 64};
+        double minTime = 0.2;
+        std::string filter;
+        std::string csvPath;
+        unsigned long long seed = 12345;
+    };
+
+    struct MicroResult
+    {
+        std::string name;
+        int rows = 0;
+        int cols = 0;
+        int p = 0;
+        long long ops = 0;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+        double bytesPerOp = 0.0;
+    };
+
+    std::vector<int> parseList(const std::string &text)
+    {
+        std::vector<int> values;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            if (!item.empty())
+            {
+                values.push_back(std::stoi(item));
+            }
+        }
+        if (values.empty())
+        {
+            throw std::runtime_error("Lista vacia: " + text);
+        }
+        return values;
+    }
+
+    MicroOptions parseArgs(int argc, char *argv[])
+    {
+        MicroOptions opts;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                std::cout << "Uso: " << argv[0] << " [--sizes 64,256,1024,2048] [--p 4,16,64] [--min-time 0.2]\n"
+                          << "       [--filter texto] [--csv archivo.csv] [--seed S]\n"
+                          << "  Las grillas son cuadradas (N = M = tamaño); --filter selecciona por nombre.\n";
+                std::exit(0);
+            }
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Falta el valor de " + arg);
+            }
+            const std::string value = argv[++i];
+            if (arg == "--sizes")
+                opts.sizes = parseList(value);
+            else if (arg == "--p")
+                opts.ps = parseList(value);
+            else if (arg == "--min-time")
+                opts.minTime = std::stod(value);
+            else if (arg == "--filter")
+                opts.filter = value;
+            else if (arg == "--csv")
+                opts.csvPath = value;
+            else if (arg == "--seed")
+                opts.seed = std::stoull(value);
+            else
+                throw std::runtime_error("Opcion desconocida: " + arg);
+        }
+        return opts;
+    }
+
+    // Campo suave (varias ondas) más ruido, para que las zonas tengan varianzas distintas
+    // como en un raster real.
+    ProblemInstance syntheticInstance(int rows, int cols, int p, Rng &rng)
+    {
+        ProblemInstance instance;
+        instance.nRows = rows;
+        instance.nCols = cols;
+        instance.p = p;
+        instance.alpha = 0.5;
+        instance.S.assign(rows, cols, 0.0);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        for (int i = 0; i < rows; ++i)
+        {
+            for (int j = 0; j < cols; ++j)
+            {
+                const double y = static_cast<double>(i) / rows;
+                const double x = static_cast<double>(j) / cols;
+                instance.S[i][j] = 10.0 * std::sin(6.0 * x) * std::cos(4.0 * y) + 5.0 * x * y + noise(rng);
+            }
+        }
+        return instance;
+    }
+
+    // Repite 'op' duplicando el número de repeticiones hasta superar minTime segundos.
+    MicroResult measure(const std::string &name, const ProblemInstance &instance, double minTime, const std::function<void()> &op)
+    {
+        using Clock = std::chrono::steady_clock;
+        op(); // calentamiento (y reservas perezosas de los buffers reutilizados)
+
+        long long reps = 1;
+        while (true)
+        {
+            const long long allocsBefore = allocCount.load();
+            const long long bytesBefore = allocBytes.load();
+            const auto start = Clock::now();
+            for (long long r = 0; r < reps; ++r)
+            {
+                op();
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            // Antes de armar el resultado: copiar 'name' también puede reservar memoria.
+            const long long allocs = allocCount.load() - allocsBefore;
+            const long long bytes = allocBytes.load() - bytesBefore;
+            if (seconds >= minTime || reps >= (1LL << 40))
+            {
+                MicroResult result;
+                result.name = name;
+                result.rows = instance.nRows;
+                result.cols = instance.nCols;
+                result.p = instance.p;
+                result.ops = reps;
+                result.nsPerOp = seconds * 1e9 / static_cast<double>(reps);
+                result.allocsPerOp = static_cast<double>(allocs) / static_cast<double>(reps);
+                result.bytesPerOp = static_cast<double>(bytes) / static_cast<double>(reps);
+                return result;
+            }
+            // Estimar cuántas repeticiones hacen falta (con margen) en vez de solo duplicar.
+            const double factor = seconds > 0.0 ? 1.4 * minTime / seconds : 100.0;
+            reps = std::max(reps * 2, static_cast<long long>(static_cast<double>(reps) * std::min(factor, 100.0)));
+        }
+    }
+
+    void printResult(const MicroResult &r)
+    {
+        std::ostringstream shape;
+        shape << r.rows << 'x' << r.cols << "/p" << r.p;
+        std::cout << std::left << std::setw(38) << r.name << std::setw(16) << shape.str() << std::right
+                  << std::setw(14) << std::fixed << std::setprecision(1) << r.nsPerOp
+                  << std::setw(12) << std::setprecision(2) << r.allocsPerOp
+                  << std::setw(14) << std::setprecision(0) << r.bytesPerOp
+                  << std::setw(12) << r.ops << '\n';
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const MicroOptions opts = parseArgs(argc, argv);
+        std::vector<MicroResult> results;
+
+        std::cout << std::left << std::setw(38) << "primitiva" << std::setw(16) << "grilla/p" << std::right
+                  << std::setw(14) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(14) << "bytes/op"
+                  << std::setw(12) << "ops" << '\n';
+
+        for (int size : opts.sizes)
+        {
+            for (int p : opts.ps)
+            {
+                if (p > size * size)
+                {
+                    continue;
+                }
+                Rng rng(opts.seed);
+                const ProblemInstance instance = syntheticInstance(size, size, p, rng);
+                const IntegralImage integral(instance);
+                const double totalVariance = calculateTotalVariance(instance);
+
+                const Solution solution = buildInitialSolution(instance, rng);
+                const Grid<int> Z = buildLabelGrid(instance, solution.rects);
+
+                // Buffers reutilizados entre repeticiones, como en el bucle de SA.
+                std::vector<double> means, variances;
+                std::vector<int> counts;
+                std::vector<unsigned long long> corners;
+                std::vector<Rect> rects = solution.rects;
+                std::vector<Rect> neighbor;
+                neighbor.reserve(rects.size());
+                Grid<int> scratchZ = Z;
+                Grid<int> neighborZ = Z;
+                BorderMove move;
+
+                auto run = [&](const std::string &name, const std::function<void()> &op)
+                {
+                    if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos)
+                    {
+                        return;
+                    }
+                    results.push_back(measure(name, instance, opts.minTime, op));
+                    printResult(results.back());
+                };
+
+                run("calculateErrorAndVariance/grid", [&]
+                    { sink = sink + calculateErrorAndVariance(instance, Z, means, variances, counts); });
+                run("calculateErrorAndVariance/rects", [&]
+                    { sink = sink + calculateErrorAndVariance(instance, integral, rects, means, variances, counts); });
+                run("isPartitionConnected/grid", [&]
+                    { sink = sink + isPartitionConnected(instance, Z); });
+                run("isPartitionConnected/rects", [&]
+                    { sink = sink + isPartitionConnected(instance, rects, corners); });
+                run("isSolutionValid/grid", [&]
+                    { sink = sink + isSolutionValid(instance, Z, totalVariance); });
+                run("isSolutionValid/rects", [&]
+                    { sink = sink + isSolutionValid(instance, integral, rects, totalVariance); });
+                // Z ya es una partición en rectángulos, así que la reparación no lo modifica.
+                run("makeRectsIfNonOverlapping", [&]
+                    { sink = sink + makeRectsIfNonOverlapping(instance, scratchZ, rects); });
+                run("generateNeighbor/grid", [&]
+                    { sink = sink + generateNeighbor(instance, Z, neighborZ, rng, move); });
+                run("generateNeighbor/rects", [&]
+                    { sink = sink + generateNeighbor(instance, rects, neighbor, rng, move); });
+                run("buildInitialSolution", [&]
+                    { sink = sink + buildInitialSolution(instance, rng).errorTotal; });
+
+                // Paso de Metropolis completo (propuesta, delta, aplicar o deshacer, mejor y
+                // adaptación de operadores). El calentamiento deja crecer los buffers perezosos.
+                const SAConfig chainCfg;
+                AnnealingChain chain(instance, integral, totalVariance, chainCfg);
+                chain.reset(solution);
+                const double temperature = estimateInitialTemperature(chain, chainCfg, rng);
+                for (int w = 0; w < 10000; ++w)
+                {
+                    chain.step(temperature, rng);
+                }
+                run("AnnealingChain::step", [&]
+                    { sink = sink + chain.step(temperature, rng); });
+            }
+        }
+
+        int allocatingSteps = 0;
+        for (const MicroResult &r : results)
+        {
+            if (r.name == "AnnealingChain::step" && r.allocsPerOp > 0.0)
+            {
+                std::cerr << "AnnealingChain::step reserva memoria en " << r.rows << 'x' << r.cols << "/p" << r.p
+                          << ": " << r.allocsPerOp << " asignaciones por paso\n";
+                ++allocatingSteps;
+            }
+        }
+
+        if (!opts.csvPath.empty())
+        {
+            std::ofstream out(opts.csvPath);
+            if (!out)
+            {
+                throw std::runtime_error("No se pudo abrir el archivo de resultados: " + opts.csvPath);
+            }
+            out << "name,rows,cols,p,ops,ns_per_op,allocs_per_op,bytes_per_op\n";
+            for (const MicroResult &r : results)
+            {
+                out << r.name << ',' << r.rows << ',' << r.cols << ',' << r.p << ',' << r.ops << ','
+                    << r.nsPerOp << ',' << r.allocsPerOp << ',' << r.bytesPerOp << '\n';
+            }
+            std::cout << "Resultados: " << opts.csvPath << '\n';
+        }
+        return allocatingSteps == 0 ? 0 : 3;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <random>
+#include <vector>
+#include "EnergyTracker.hpp"
+#include "IntegralImage.hpp"
+#include "Move.hpp"
+#include "MoveOperators.hpp"
+#include "ProblemInstance.hpp"
+#include "Random.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+#include "Telemetry.hpp"
+#include "ZoneAdjacency.hpp"
+
+// Estado de una cadena de Metropolis sobre particiones en rectángulos: solución
+// actual, contabilidad de energía (errorTotal + penaltyWeight * penalty), mejor
+// solución vista y buffers reutilizados. Lo comparten SA, parallel tempering y
+// demás motores, de modo que todos usan el mismo vecindario y la misma energía.
+class AnnealingChain
+{
+public:
+    AnnealingChain(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg);
+
+    // Fija la solución actual (y la mejor) y recalcula la energía.
+    void reset(const Solution &start);
+
+    // Reemplaza la solución actual (p.ej. al migrar desde otra cadena) sin olvidar la
+    // mejor vista: esta solo cambia si 'start' la mejora.
+    void restart(const Solution &start);
+
+    // Una iteración de Metropolis a la temperatura dada. Devuelve true si se aceptó el vecino.
+    bool step(double temperature, Rng &rng);
+
+    // Propone un movimiento y devuelve su variación de energía sin aplicarlo (ver
+    // estimateInitialTemperature). Devuelve false si no hubo movimiento.
+    bool sampleDelta(Rng &rng, double &delta);
+
+    const Solution &current() const { return currentSol; }
+    double energy() const { return tracker.energy(); }
+    const Solution &best() const { return bestSol; }
+    double bestEnergy() const { return bestE; }
+
+    long long iterations() const { return iterCount; }
+    long long accepted() const { return acceptCount; }
+    long long improvements() const { return improveCount; }
+    long long proposalFailures() const { return proposalFailCount; }
+    const MoveOperatorSet &operators() const { return operatorSet; }
+
+    // Vuelca los contadores, el desglose por fase y el uso de operadores en 'telemetry'.
+    void fillTelemetry(SATelemetry &telemetry) const;
+
+private:
+    const ProblemInstance &instance;
+    const IntegralImage &integral;
+    EnergyTracker tracker;
+    Solution currentSol;
+    Solution bestSol;
+    double bestE = 0.0;
+    Move move;
+    ZoneAdjacency adjacency;
+    MoveOperatorSet operatorSet;
+    std::vector<unsigned long long> corners; // buffer del chequeo de mosaico (SPP_DEBUG_CHECKS)
+    std::uniform_real_distribution<double> uniform01{0.0, 1.0};
+
+    long long iterCount = 0;
+    long long acceptCount = 0;
+    long long improveCount = 0;
+    long long proposalFailCount = 0;
+    StepPhaseTimes phaseTimes; // solo se acumula con SPP_TELEMETRY
+};
+
+// Construye la solución de partida: cortes guillotina según cfg.seeding (ver
+// buildSeededSolution; si seed != nullptr se parte de esa partición ya sembrada, p.ej. la
+// de buildSharedSeed) y, si no cumple las restricciones, hasta 1000 movimientos de borde
+// buscando una partición válida. Si telemetry != nullptr, informa cuántos intentos hicieron
+// falta y por qué se descartaron.
+Solution buildStartingSolution(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg, Rng &rng, StartTelemetry *telemetry = nullptr, const Solution *seed = nullptr);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "OutputQueue.hpp"
+#include "ProblemInstance.hpp"
+#include "Rect.hpp"
+#include "SAConfig.hpp"
+
+// Trabajo del modo batch: una instancia con sus parámetros p y alpha.
+struct BatchJob
+{
+    std::string instancePath;
+    int p = 0;
+    double alpha = 0.0;
+};
+
+// Resultado de un trabajo del modo batch.
+struct BatchResult
+{
+    BatchJob job;
+    std::string outputName; // prefijo de los archivos _initial.out / _best.out
+    int nRows = 0;
+    int nCols = 0;
+    double energy = 0.0;     // errorTotal + penaltyWeight * penalty
+    double errorTotal = 0.0;
+    long long iterations = 0;
+    double loadSeconds = 0.0;
+    double solveSeconds = 0.0;
+    std::string error; // vacío si el trabajo terminó bien
+};
+
+// Lee el manifiesto: una línea "instancia p alpha" por trabajo; '#' inicia un comentario.
+// La instancia se resuelve igual que el argumento de la línea de comandos.
+std::vector<BatchJob> readBatchManifest(const std::string &path);
+
+// Salida adicional del mejor resultado de cada trabajo (p.ej. el heatmap): recibe la
+// instancia, los rectángulos de las zonas y la ruta del _best.out. Corre en la etapa de salida.
+using BatchRenderHook = std::function<void(const ProblemInstance &, const std::vector<Rect> &, const std::string &)>;
+
+// Resuelve todos los trabajos en un pool con robo de trabajo (cfg.threads hilos; 0 = núcleos
+// disponibles). La carga de cada instancia es una tarea aparte, de modo que se solapa con la
+// resolución de otras. Cada trabajo se resuelve con solveInstance (el mismo cfg.mode que
+// una ejecución individual) y cfg.threads = 1; tempering e islas igual usan un hilo por
+// réplica/isla. La escritura de {outputName}_initial.out, _best.out, _best.stats.json y lo que agregue
+// 'render' se encola en 'output' (o en una etapa propia si es nullptr), así el hilo pasa
+// directamente al siguiente trabajo. Antes de escribir outputDir/summary.csv se espera a
+// que terminen todas las salidas. Los resultados se devuelven en el orden del manifiesto.
+std::vector<BatchResult> runBatch(const std::vector<BatchJob> &jobs, const SAConfig &cfg, const std::string &outputDir, OutputQueue *output = nullptr, const BatchRenderHook &render = BatchRenderHook());
+
+// Escribe la tabla resumen (CSV) de un batch.
+void writeBatchSummary(const std::string &path, const std::vector<BatchResult> &results);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include "IntegralImage.hpp"
+#include "Move.hpp"
+#include "ProblemInstance.hpp"
+#include "Rect.hpp"
+
+// Sumas suficientes de un conjunto de celdas: con ellas se obtienen media, varianza y SSE.
+struct ZoneStats
+{
+    double sum = 0.0;
+    double sumSq = 0.0;
+    int count = 0;
+};
+
+// Contabilidad incremental de la energía errorTotal + penaltyWeight * penalty.
+// Mantiene sum, sumSq y count por zona, de modo que un movimiento que transfiere
+// una franja entre dos zonas se evalúa (y se confirma) sin recorrer la grilla.
+class EnergyTracker
+{
+public:
+    EnergyTracker(const ProblemInstance &instance, double totalVariance, double penaltyWeight);
+
+    // Reinicia el estado a partir de una partición en rectángulos (zona k = rects[k - 1]).
+    void reset(const IntegralImage &integral, const std::vector<Rect> &rects);
+
+    double energy() const { return errorTotal + penaltyWeight * penalty; }
+    double error() const { return errorTotal; }
+    double variancePenalty() const { return penalty; }
+    const ZoneStats &zone(int k) const { return zones[k]; }
+
+    // Variación de energía si las celdas de 'strip' pasan de la zona 'from' a la zona 'to'.
+    double transferDelta(int from, int to, const ZoneStats &strip) const;
+
+    // Confirma la transferencia (solo al aceptar el movimiento).
+    void applyTransfer(int from, int to, const ZoneStats &strip);
+
+    // Variación de energía del movimiento: solo se recalculan las zonas que cambian
+    // (cada zona debe aparecer a lo sumo una vez en move.changes).
+    double moveDelta(const IntegralImage &integral, const Move &move) const;
+
+    // Confirma el movimiento (solo al aceptarlo).
+    void applyMove(const IntegralImage &integral, const Move &move);
+
+    static ZoneStats statsOf(const IntegralImage &integral, const Rect &r);
+
+private:
+    double zoneError(const ZoneStats &z) const;
+    double zonePenalty(const ZoneStats &z) const;
+
+    int p = 0;
+    double maxVariance = 0.0;
+    double penaltyWeight = 0.0;
+    std::vector<ZoneStats> zones; // índice 1..p
+    double errorTotal = 0.0;
+    double penalty = 0.0;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Matriz densa en un único bloque contiguo, por filas, con el inicio de cada fila
+// alineado a kAlignment bytes. G[i] devuelve un puntero a la fila i, por lo que
+// G[i][j] sigue funcionando como con std::vector<std::vector<T>>, pero los recorridos
+// completos son lineales en memoria y vectorizables.
+//
+// También puede ser una vista de solo lectura sobre memoria ajena (p.ej. un archivo
+// proyectado con mmap); 'owner' mantiene esa memoria viva mientras exista la vista.
+// Una vista solo guarda el puntero const: el primer acceso no const (operator[] o data())
+// copia los datos a un bloque propio (copia en escritura), así nunca se entregan filas
+// escribibles sobre memoria de solo lectura. Los lectores deben tomar la grilla por
+// referencia const para no provocar esa copia. assign() también la convierte en una
+// grilla propia, y copiar una Grid siempre produce una copia propia.
+template <typename T>
+class Grid
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Grid solo admite tipos triviales (int, float, double...)");
+
+public:
+    static constexpr std::size_t kAlignment = 64;
+
+    Grid() = default;
+
+    Grid(int rows, int cols, const T &value = T())
+    {
+        assign(rows, cols, value);
+    }
+
+    static Grid view(int rows, int cols, const T *data, std::size_t stride, std::shared_ptr<const void> owner)
+    {
+        Grid g;
+        g.nRows = rows;
+        g.nCols = cols;
+        g.rowStride = stride;
+        g.cptr = data;
+        g.owner = std::move(owner);
+        return g;
+    }
+
+    Grid(const Grid &other)
+    {
+        copyFrom(other);
+    }
+
+    Grid &operator=(const Grid &other)
+    {
+        if (this != &other)
+        {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    Grid(Grid &&other) noexcept
+    {
+        swap(other);
+    }
+
+    Grid &operator=(Grid &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Grid tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Redimensiona y rellena con 'value'. Reutiliza el bloque si ya tiene capacidad.
+    void assign(int rows, int cols, const T &value = T())
+    {
+        reshape(rows, cols);
+        for (int i = 0; i < nRows; ++i)
+        {
+            std::fill(ptr + static_cast<std::size_t>(i) * rowStride, ptr + static_cast<std::size_t>(i) * rowStride + nCols, value);
+        }
+    }
+
+    int rows() const { return nRows; }
+    int cols() const { return nCols; }
+    std::size_t stride() const { return rowStride; } // elementos entre filas consecutivas
+    bool empty() const { return nRows == 0 || nCols == 0; }
+    bool isView() const { return owner != nullptr; }
+
+    T *operator[](int i) { return writable() + static_cast<std::size_t>(i) * rowStride; }
+    const T *operator[](int i) const { return cptr + static_cast<std::size_t>(i) * rowStride; }
+
+    T *data() { return writable(); }
+    const T *data() const { return cptr; }
+
+    void swap(Grid &other) noexcept
+    {
+        std::swap(nRows, other.nRows);
+        std::swap(nCols, other.nCols);
+        std::swap(rowStride, other.rowStride);
+        std::swap(ptr, other.ptr);
+        std::swap(cptr, other.cptr);
+        std::swap(storage, other.storage);
+        std::swap(capacity, other.capacity);
+        std::swap(owner, other.owner);
+    }
+
+private:
+    struct AlignedFree
+    {
+        void operator()(T *p) const { std::free(p); }
+    };
+
+    // Copia en escritura: una vista se reemplaza por una copia propia de sus datos.
+    T *writable()
+    {
+        if (owner)
+        {
+            Grid own(*this);
+            swap(own);
+        }
+        return ptr;
+    }
+
+    static std::size_t paddedStride(int cols)
+    {
+        const std::size_t perLine = kAlignment / sizeof(T) > 0 ? kAlignment / sizeof(T) : 1;
+        return (static_cast<std::size_t>(cols) + perLine - 1) / perLine * perLine;
+    }
+
+    void reshape(int rows, int cols)
+    {
+        const std::size_t stride = paddedStride(cols);
+        const std::size_t needed = static_cast<std::size_t>(rows) * stride;
+        if (owner || needed > capacity)
+        {
+            owner.reset();
+            storage.reset();
+            capacity = 0;
+            ptr = nullptr;
+            cptr = nullptr;
+            if (needed > 0)
+            {
+                const std::size_t bytes = (needed * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+                T *p = static_cast<T *>(std::aligned_alloc(kAlignment, bytes));
+                if (!p)
+                {
+                    throw std::bad_alloc();
+                }
+                storage.reset(p);
+                capacity = needed;
+                ptr = p;
+                cptr = p;
+            }
+        }
+        nRows = rows;
+        nCols = cols;
+        rowStride = stride;
+    }
+
+    void copyFrom(const Grid &other)
+    {
+        reshape(other.nRows, other.nCols);
+        for (int i = 0; i < nRows; ++i)
+        {
+            std::copy(other[i], other[i] + nCols, (*this)[i]);
+        }
+    }
+
+    int nRows = 0;
+    int nCols = 0;
+    std::size_t rowStride = 0;
+    T *ptr = nullptr;        // nullptr en una vista
+    const T *cptr = nullptr; // lectura: igual a ptr o la memoria de la vista
+    std::unique_ptr<T, AlignedFree> storage;
+    std::size_t capacity = 0;
+    std::shared_ptr<const void> owner;
+};
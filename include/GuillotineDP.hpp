@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include "ProblemInstance.hpp"
+#include "SA.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Resumen de una ejecución de la programación dinámica (ver guillotineDP).
+struct DPStats
+{
+    long long rects = 0;       // sub-rectángulos memorizados
+    long long states = 0;      // pares (rectángulo, k) de la tabla
+    long long transitions = 0; // combinaciones corte x reparto evaluadas
+    int cutStride = 1;         // paso de los cortes (1 = óptimo exacto)
+    double energy = 0.0;       // energía de la solución (óptima entre las guillotina con ese paso)
+    double elapsedSeconds = 0.0;
+};
+
+// Óptimo de la energía (error + penaltyWeight * penalización) entre todas las particiones
+// guillotina en p rectángulos. La energía es aditiva por zona, así que
+//   E(R, 1) = energía de R como una sola zona (cuatro accesos a la tabla de sumas)
+//   E(R, k) = min sobre cortes c de R y repartos k1 + k2 = k de E(R1, k1) + E(R2, k2)
+// Los sub-rectángulos se memorizan en una tabla hash compacta y se resuelven por
+// niveles de alto + ancho (cada nivel depende solo de los anteriores) repartiendo cada
+// nivel entre cfg.threads hilos. Con cfg.dpCutStride = s > 1 los cortes solo caen en
+// filas/columnas múltiplos de s: la tabla se reduce ~s^4 veces y el resultado es el
+// óptimo de ese subconjunto (cota superior del óptimo exacto).
+//
+// Misma firma que parallelSimulatedAnnealing: chainStats recibe una sola entrada
+// (energía inicial = final) e initialOut la misma solución, ya que no hay partida.
+// Lanza std::runtime_error si la tabla superaría cfg.dpMaxStates o si p no cabe (o supera 32767).
+Solution guillotineDP(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *chainStats = nullptr, Solution *initialOut = nullptr, DPStats *dpStats = nullptr);
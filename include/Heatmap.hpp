@@ -1,11 +1,30 @@
 #pragma once
 
-#include <vector>
 #include <string>
+#include <vector>
+#include "Grid.hpp"
+#include "Rect.hpp"
+
+// Opciones del renderizador por franjas (ver saveHeatmap).
+struct HeatmapOptions
+{
+    int factor = 10;      // píxeles por celda
+    int maxOutputDim = 0; // lado máximo de la imagen; si se supera se baja el factor y, si ni
+                          // con 1 alcanza, cada píxel promedia un bloque de celdas (vista
+                          // previa de menor detalle). 0 = sin límite
+    int bandRows = 256;   // filas de salida que se renderizan a la vez
+};
 
 // Visualiza la matriz de datos (M) como mapa de calor y, opcionalmente,
 // delimita las zonas indicadas por la matriz Z.
-void plotHeatmap(const std::vector<std::vector<float>> &M, int factor, const std::vector<std::vector<int>> &Z = {});
+void plotHeatmap(const Grid<float> &M, int factor, const Grid<int> &Z = Grid<int>());
 
 // Genera la imagen de calor y la guarda en outputPath (e.g. PNG).
-void saveHeatmap(const std::vector<std::vector<float>> &M, int factor, const std::vector<std::vector<int>> &Z, const std::string &outputPath);
+void saveHeatmap(const Grid<float> &M, int factor, const Grid<int> &Z, const std::string &outputPath);
+
+// Renderiza el mapa de calor por franjas horizontales y dibuja el contorno de cada zona
+// a partir de la lista de rectángulos. Con extensión .ppm/.pnm la imagen se escribe franja
+// a franja y la memoria queda acotada por una franja; con otros formatos (PNG, ...) se
+// arma solo la imagen final de 8 bits y se codifica con OpenCV.
+void saveHeatmap(const Grid<double> &M, const std::vector<Rect> &rects, const std::string &outputPath, const HeatmapOptions &options = HeatmapOptions());
+void saveHeatmap(const Grid<float> &M, const std::vector<Rect> &rects, const std::string &outputPath, const HeatmapOptions &options = HeatmapOptions());
@@ -1,25 +1,59 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
+#include "Grid.hpp"
 #include "ProblemInstance.hpp"
+#include "RunOptions.hpp"
+#include "SA.hpp"
 #include "SAConfig.hpp"
 
 namespace IO
 {
 
+    // Resuelve el argumento de instancia: un nombre ("grande_1"), un nombre con extensión
+    // ("grande_1.spp") o una ruta. Los dos primeros se buscan en data/instances/.
+    std::string resolveInstancePath(const std::string &arg);
+
+    // Tipo de los valores en el formato binario .sppb.
+    enum class SppbDtype : std::uint32_t
+    {
+        Float32 = 1,
+        Float64 = 2,
+    };
+
     // Lee el archivo de instancia (N, M y matriz S).
+    // Los archivos con extensión .sppb se leen con readBinaryInstanceFromFile.
     ProblemInstance readInstanceFromFile(const std::string &path);
 
-    // Lee p y alpha desde la consola.
-    // Valida que p > 0 y alpha > 0.
+    // Lee una instancia en formato binario .sppb proyectando el archivo en memoria (mmap).
+    // Formato: cabecera de 64 bytes ("SPPB", versión, N, M, dtype, tamaño de cabecera; enteros
+    // de 32 bits en little-endian) seguida de N*M valores float32 o float64 en orden por filas.
+    ProblemInstance readBinaryInstanceFromFile(const std::string &path);
+
+    // Escribe la instancia en formato binario .sppb (conversor desde el formato de texto .spp).
+    void writeBinaryInstanceToFile(const std::string &path, const ProblemInstance &instance, SppbDtype dtype = SppbDtype::Float64);
+
+    // Lee p y alpha desde la consola (solo los que aún no estén definidos, p <= 0 / alpha <= 0).
+    // Valida que p > 0 y alpha en ]0,1]. Lanza std::runtime_error si la entrada se agota.
     void readParamsFromConsole(ProblemInstance &instance);
 
     // Lee el archivo de configuración
     SAConfig readConfigFromJson(const std::string& path);
 
+    // Completa p, alpha y el directorio de salida con las claves "p", "alpha" y "output_dir"
+    // del JSON, solo si no fueron indicados por línea de comandos.
+    void readRunOptionsFromJson(const std::string &path, RunOptions &opts);
+
     // Escribe el archivo de salida con:
     //  - primera línea: errorTotal
     //  - línea en blanco
     //  - matriz de etiquetas Z de tamaño N x M
-    void writeSolutionToFile(const std::string &path, double errorTotal, const ProblemInstance &instance, const std::vector<std::vector<int>> &Z);
+    //  - si seed != 0, una línea final "# seed=<seed>" para reproducir la ejecución
+    void writeSolutionToFile(const std::string &path, double errorTotal, const ProblemInstance &instance, const Grid<int> &Z, unsigned long long seed = 0);
+
+    // Escribe la telemetría de la ejecución (una entrada por cadena/réplica) en JSON:
+    // contadores, tiempos por etapa, uso de operadores y, si se pidió, la traza periódica.
+    void writeStatsToJson(const std::string &path, const std::vector<SAStats> &chainStats, const SAConfig &cfg);
 }
\ No newline at end of file
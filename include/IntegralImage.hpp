@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include "ProblemInstance.hpp"
+#include "Rect.hpp"
+
+// Tabla de sumas acumuladas 2D (summed-area table) sobre S y S².
+// Se construye una vez por instancia; luego la suma, media, varianza y
+// SSE de cualquier rectángulo se obtienen con cuatro accesos cada una.
+class IntegralImage
+{
+public:
+    IntegralImage() = default;
+    explicit IntegralImage(const ProblemInstance &instance);
+
+    double sum(const Rect &r) const;
+    double sumSq(const Rect &r) const;
+    int count(const Rect &r) const { return r.area(); }
+
+    double mean(const Rect &r) const;
+    double variance(const Rect &r) const; // varianza poblacional (SSE / n)
+    double sse(const Rect &r) const;      // suma de errores cuadrados respecto de la media
+
+private:
+    double lookup(const std::vector<double> &table, const Rect &r) const;
+
+    int stride = 0; // nCols + 1
+    std::vector<double> sums;
+    std::vector<double> sumsSq;
+};
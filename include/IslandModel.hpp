@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include "ProblemInstance.hpp"
+#include "SA.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Modelo de islas: cfg.islands cadenas de SA (AnnealingChain + CoolingSchedule, como
+// simulatedAnnealing), cada una en su propio hilo, que cooperan a través de una ranura
+// compartida con la mejor partición global. Cada cfg.islandMigrationInterval iteraciones
+// una isla publica su mejor solución si supera a la global y, si lleva
+// cfg.islandStagnation iteraciones sin mejorar y hay una global mejor que su propia
+// mejor, la adopta o (con probabilidad cfg.islandCrossoverRate) la cruza con su solución
+// actual a lo largo de una línea guillotina común.
+//
+// La ranura es un seqlock sin bloqueos: publicar y leer son intentos que nunca esperan
+// (si otro hilo está escribiendo se reintenta en la siguiente migración), así que las
+// islas no se frenan entre sí. El presupuesto es cfg.totalTimeSeconds (o
+// cfg.maxTimeSeconds si es 0) y cfg.maxIterations por isla.
+// Si islandStats != nullptr, devuelve las estadísticas de cada isla (con sus migraciones).
+// Si initialOut != nullptr, devuelve la solución inicial de la isla ganadora.
+Solution islandAnnealing(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *islandStats = nullptr, Solution *initialOut = nullptr);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Archivo proyectado en memoria de solo lectura (mmap). El mapeo se libera al destruir el objeto.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const unsigned char *data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const unsigned char *bytes = nullptr;
+    std::size_t length = 0;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include "Rect.hpp"
+
+// Cambio del rectángulo de una zona (antes y después del movimiento).
+struct RectChange
+{
+    int zone = 0;
+    Rect before;
+    Rect after;
+};
+
+// Movimiento sobre una partición en rectángulos. Se aplica in situ y se deshace
+// restaurando los rectángulos anteriores; el objeto se reutiliza entre iteraciones,
+// por lo que tras la primera no vuelve a reservar memoria.
+struct Move
+{
+    std::vector<RectChange> changes;
+
+    void clear() { changes.clear(); }
+    bool empty() const { return changes.empty(); }
+};
+
+// Aplica el movimiento sobre la lista de rectángulos (zona k = rects[k - 1]).
+void applyMove(std::vector<Rect> &rects, const Move &move);
+
+// Deshace un movimiento aplicado previamente con applyMove.
+void undoMove(std::vector<Rect> &rects, const Move &move);
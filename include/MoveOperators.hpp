@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Move.hpp"
+#include "Random.hpp"
+#include "Rect.hpp"
+#include "SAConfig.hpp"
+#include "ZoneAdjacency.hpp"
+
+// Operador de vecindario sobre una partición en rectángulos. Cada operador describe su
+// movimiento en 'move' (ver applyMove) y debe conservar la partición rectangular por
+// construcción; además, la unión de los rectángulos que modifica no cambia, que es lo
+// que permite actualizar ZoneAdjacency localmente. Devuelve false si no encontró un
+// movimiento aplicable.
+class MoveOperator
+{
+public:
+    virtual ~MoveOperator() = default;
+    virtual const char *name() const = 0;
+    virtual bool propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move) = 0;
+};
+
+// Desplaza una fila/columna entre dos zonas que comparten el lado completo.
+std::unique_ptr<MoveOperator> makeBorderShiftOperator();
+
+// Desliza k celdas un corte guillotina: todos los rectángulos apoyados a ambos lados
+// del segmento de corte se mueven juntos.
+std::unique_ptr<MoveOperator> makeGuillotineSlideOperator(int maxCells);
+
+// Fusiona dos zonas adyacentes cuya unión es un rectángulo y parte en dos otra zona.
+std::unique_ptr<MoveOperator> makeMergeSplitOperator();
+
+// Vuelve a cortar (en otra posición u orientación) dos zonas cuya unión es un rectángulo.
+std::unique_ptr<MoveOperator> makeRecutOperator();
+
+// Conjunto de operadores con probabilidades de selección. Las probabilidades parten de
+// los pesos configurados y, si opAdaptive está activo, cada opAdaptInterval
+// movimientos se reajustan según la tasa de aceptación reciente de cada operador
+// (sin bajar de opMinProbability mientras su peso no sea 0).
+class MoveOperatorSet
+{
+public:
+    explicit MoveOperatorSet(const SAConfig &cfg);
+
+    // Añade un operador con el peso dado (peso 0 = deshabilitado).
+    void add(std::unique_ptr<MoveOperator> op, double weight);
+
+    // Elige un operador y propone un movimiento. Si el elegido no encuentra uno, se recurre
+    // al primero del conjunto (el desplazamiento de borde) siempre que su peso no sea 0;
+    // si lo es, devuelve false y la iteración cuenta como propuesta fallida.
+    bool propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move);
+
+    // Registra si el último movimiento propuesto fue aceptado.
+    void record(bool accepted);
+
+    size_t size() const { return ops.size(); }
+    const char *name(size_t i) const { return ops[i]->name(); }
+    double probability(size_t i) const { return probs[i]; }
+    long long attempts(size_t i) const { return totalAttempts[i]; }
+    long long accepted(size_t i) const { return totalAccepted[i]; }
+
+private:
+    void adapt();
+
+    std::vector<std::unique_ptr<MoveOperator>> ops;
+    std::vector<double> weights;
+    std::vector<double> probs;
+    std::vector<long long> totalAttempts;
+    std::vector<long long> totalAccepted;
+    std::vector<double> windowAttempts; // contadores recientes (con decaimiento)
+    std::vector<double> windowAccepted;
+
+    bool adaptive = true;
+    int adaptInterval = 1000;
+    double minProbability = 0.05;
+    long long sinceAdapt = 0;
+    size_t last = 0;
+    std::uniform_real_distribution<double> uniform01{0.0, 1.0};
+};
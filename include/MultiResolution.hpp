@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ProblemInstance.hpp"
+#include "Random.hpp"
+#include "SA.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Pipeline multirresolución (mode "pyramid") para grillas grandes. Se arma una pirámide de
+// S promediando bloques de 2x2, 4x4, ... y se resuelve primero el nivel más grueso con SA
+// completo; luego la partición se proyecta al nivel siguiente (cada fila/columna gruesa
+// cubre dos finas) y se refina con un SA corto, nivel a nivel, hasta la resolución completa.
+//
+// Cada nivel usa la misma energía (SSE + penaltyWeight * penalización) sobre su propia
+// grilla. Como la energía escala con la cantidad de celdas, T0 y Tf se dividen por el área
+// del bloque; los niveles de refinamiento parten de cfg.pyramidRefineT0 veces la T0 del
+// nivel más grueso (en la misma escala), de modo que no destruyen la partición proyectada.
+// La resolución completa recibe cfg.pyramidFineShare del presupuesto (tiempo e
+// iteraciones) y los niveles gruesos se reparten el resto.
+//
+// Con cfg.pyramidLevels = 0 se agregan niveles mientras el lado menor del más grueso sea
+// >= cfg.pyramidMinSide; sin niveles (grilla chica) equivale a simulatedAnnealing.
+// stats recibe los totales de todos los niveles, la telemetría de la resolución completa
+// y el detalle por nivel (SATelemetry::levels); initialOut, la partida proyectada a la
+// resolución completa.
+Solution multiResolutionAnnealing(const ProblemInstance &instance, const SAConfig &cfg, Rng &rng, Solution *initialOut = nullptr, SAStats *stats = nullptr);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Etapa de salida asíncrona: hilos de E/S y renderizado alimentados por una cola acotada.
+// Los hilos del solver encolan la escritura de archivos y heatmaps y siguen con el
+// siguiente trabajo; si la cola está llena, submit() espera (contrapresión), de modo que
+// la memoria retenida por las salidas pendientes está acotada.
+//
+// flush() espera a que se vacíe la cola y relanza la primera excepción de una tarea;
+// el destructor vacía la cola y une los hilos (sin relanzar).
+class OutputQueue
+{
+public:
+    using Task = std::function<void()>;
+
+    OutputQueue(int threads, std::size_t capacity);
+    ~OutputQueue();
+
+    OutputQueue(const OutputQueue &) = delete;
+    OutputQueue &operator=(const OutputQueue &) = delete;
+
+    void submit(Task task);
+
+    // Espera a que terminen todas las tareas enviadas.
+    void flush();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    void run();
+
+    std::vector<std::thread> workers;
+    std::deque<Task> tasks;
+    const std::size_t capacity;
+    std::size_t running = 0; // tareas tomadas por un hilo y aún no terminadas
+    bool stopping = false;
+
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::condition_variable idle;
+    std::exception_ptr error;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+#include "ProblemInstance.hpp"
+#include "SA.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Ejecuta cfg.chains cadenas de SA independientes (cada una con su generador y su
+// solución inicial) repartidas en cfg.threads hilos, y devuelve la de menor energía.
+// Si chainStats != nullptr, devuelve las estadísticas de cada cadena (en orden).
+// Si initialOut != nullptr, devuelve la solución inicial de la cadena ganadora.
+// Con cfg.mode == "pyramid" cada cadena es un multiResolutionAnnealing.
+Solution parallelSimulatedAnnealing(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *chainStats = nullptr, Solution *initialOut = nullptr);
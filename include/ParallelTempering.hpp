@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+#include "ProblemInstance.hpp"
+#include "SA.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Parallel tempering (replica exchange): una réplica por escalón de temperatura, cada
+// una en su propio hilo, con intentos periódicos de intercambio entre escalones vecinos.
+// La escalera y el intervalo de intercambio se configuran con cfg.pt*. El presupuesto es
+// cfg.totalTimeSeconds (o cfg.maxTimeSeconds si es 0) y cfg.maxIterations por réplica.
+// Si replicaStats != nullptr, devuelve las estadísticas de cada réplica.
+// Si initialOut != nullptr, devuelve la solución inicial de la réplica ganadora.
+Solution parallelTempering(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *replicaStats = nullptr, Solution *initialOut = nullptr);
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <vector>
+#include "Grid.hpp"
 
 struct ProblemInstance
 {
     int nRows = 0;                      // N
     int nCols = 0;                      // M
-    std::vector<std::vector<double>> S; // matriz S[N][M]
+    Grid<double> S;                     // matriz S[N][M], contigua por filas
 
     int p = 0;        // nº de zonas/sensores
     double alpha = 0; // nivel de homogeneidad
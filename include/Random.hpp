@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// Generador xoshiro256** (Blackman y Vigna): rápido, 256 bits de estado y con saltos
+// de 2^128 pasos para obtener flujos independientes por hilo/cadena a partir de una
+// única semilla. Cumple UniformRandomBitGenerator, así que sirve con las distribuciones
+// de <random>.
+class Rng
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0x9E3779B97F4A7C15ULL)
+    {
+        reseed(seed);
+    }
+
+    // El estado se expande desde la semilla con splitmix64, como recomiendan los autores.
+    void reseed(std::uint64_t seed)
+    {
+        for (auto &word : s)
+        {
+            seed += 0x9E3779B97F4A7C15ULL;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Avanza 2^128 pasos: equivale a 2^128 llamadas a operator().
+    void jump()
+    {
+        static const std::uint64_t kJump[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                              0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+        std::uint64_t t[4] = {0, 0, 0, 0};
+        for (std::uint64_t word : kJump)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (word & (std::uint64_t{1} << b))
+                {
+                    t[0] ^= s[0];
+                    t[1] ^= s[1];
+                    t[2] ^= s[2];
+                    t[3] ^= s[3];
+                }
+                (*this)();
+            }
+        }
+        s[0] = t[0];
+        s[1] = t[1];
+        s[2] = t[2];
+        s[3] = t[3];
+    }
+
+    // Flujo 'index' de esta semilla: el generador saltado 'index' veces.
+    Rng stream(unsigned index) const
+    {
+        Rng r = *this;
+        for (unsigned k = 0; k < index; ++k)
+        {
+            r.jump();
+        }
+        return r;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t s[4];
+};
+
+// Semilla no nula de 64 bits tomada de std::random_device, para cuando no se fija una.
+inline std::uint64_t randomSeed()
+{
+    std::random_device rd;
+    std::uint64_t seed = 0;
+    while (seed == 0)
+    {
+        seed = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+    }
+    return seed;
+}
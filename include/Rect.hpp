@@ -0,0 +1,14 @@
+#pragma once
+
+// Rectángulo de celdas [top, bottom] x [left, right] (índices inclusivos).
+struct Rect
+{
+    int top = 0;
+    int bottom = 0;
+    int left = 0;
+    int right = 0;
+
+    int height() const { return bottom - top + 1; }
+    int width() const { return right - left + 1; }
+    int area() const { return height() * width(); }
+};
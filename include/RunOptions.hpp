@@ -0,0 +1,42 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include "SAConfig.hpp"
+
+// Opciones de ejecución (línea de comandos y claves de ejecución del JSON).
+// Precedencia: línea de comandos > JSON > valor por defecto / consola.
+struct RunOptions
+{
+    std::string instancePath;                            // vacío = data/instances/instance.spp
+    std::string configPath = "data/config/default.json"; // --config
+    std::string batchManifest;                           // --batch; vacío = una sola instancia
+    std::string outputDir;                               // --out-dir / "output_dir"; vacío = data/solutions
+
+    int p = 0;          // --p / "p"; 0 = preguntar por consola
+    double alpha = 0.0; // --alpha / "alpha"; 0 = preguntar por consola
+
+    // Sobrescriben la configuración del JSON si se indican (< 0 = no indicado).
+    long long seed = -1;      // --seed
+    double timeSeconds = -1.0; // --time (presupuesto total de reloj)
+    int threads = -1;         // --threads
+    int traceInterval = -1;   // --trace (iteraciones entre muestras de la traza; 0 = sin traza)
+
+    int heatmapMaxDim = 4096;            // --heatmap-max-dim: lado máximo del heatmap (0 = resolución completa)
+    std::string heatmapFormat = "png";   // --heatmap-format: "png" o "ppm" (escrito por franjas)
+
+    std::string convertTo;          // --convert: escribe la instancia en formato .sppb y termina
+    std::string dtype = "float64";  // --dtype del archivo convertido: "float32" o "float64"
+
+    bool showHelp = false; // --help
+};
+
+// Interpreta argv. Acepta "--opcion valor" y "--opcion=valor"; el único argumento
+// posicional es la instancia. Lanza std::runtime_error ante opciones inválidas.
+RunOptions parseCommandLine(int argc, char *argv[]);
+
+// Aplica --seed, --time, --threads y --trace sobre la configuración leída del JSON.
+void applyCommandLineOverrides(const RunOptions &opts, SAConfig &cfg);
+
+// Imprime la ayuda de la línea de comandos.
+void printUsage(std::ostream &out, const std::string &program);
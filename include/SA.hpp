@@ -1,9 +1,38 @@
 #pragma once
 
+#include <random>
 #include "ProblemInstance.hpp"
+#include "Random.hpp"
 #include "SAConfig.hpp"
 #include "Solution.hpp"
+#include "Telemetry.hpp"
+
+// Estadísticas de una ejecución (cadena) de Simulated Annealing.
+struct SAStats
+{
+    long long iterations = 0;        // iteraciones del bucle principal
+    long long accepted = 0;          // vecinos aceptados (Metropolis)
+    long long improvements = 0;      // veces que mejoró la mejor solución
+    double initialTemperature = 0.0; // T0 usada (configurada o estimada)
+    int reheats = 0;                 // recalentamientos por estancamiento
+    double timeToTarget = -1.0;      // segundos hasta bestEnergy <= cfg.targetEnergy; -1 = no se alcanzó
+    double initialEnergy = 0.0;
+    double bestEnergy = 0.0;
+    double elapsedSeconds = 0.0;
+    SATelemetry telemetry;           // contadores, tiempos por etapa y traza (ver Telemetry.hpp)
+};
+
+// Generador de la cadena/réplica 'stream': flujo independiente (salto de 2^128) de la
+// semilla cfg.seed; si cfg.seed == 0 la raíz sale de std::random_device.
+Rng makeChainRng(const SAConfig &cfg, unsigned stream);
 
 // Ejecuta el algoritmo de Simulated Annealing y devuelve la mejor solución encontrada.
 // Si initialOut != nullptr, también devuelve la solución inicial antes de SA.
 Solution simulatedAnnealing(const ProblemInstance &instance, const SAConfig &cfg, Solution *initialOut = nullptr);
+
+// Igual que la anterior pero con un generador propio (la solución inicial también sale de él).
+// Si stats != nullptr, devuelve las estadísticas de la ejecución. Si start != nullptr, parte
+// de esa partición en lugar de construir una (p.ej. el refinamiento de multiResolutionAnnealing).
+// Si seed != nullptr, es la partición sembrada que buildStartingSolution usa en lugar de
+// cfg.seeding (la partida compartida de buildSharedSeed).
+Solution simulatedAnnealing(const ProblemInstance &instance, const SAConfig &cfg, Rng &rng, Solution *initialOut = nullptr, SAStats *stats = nullptr, const Solution *start = nullptr, const Solution *seed = nullptr);
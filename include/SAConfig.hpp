@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 struct SAConfig
 {
     double T0 = 1000.0;          // temperatura inicial
@@ -9,4 +11,65 @@ struct SAConfig
     double coolingFactor = 0.95;   // alpha del enfriamiento
     double maxTimeSeconds = 5.0;   // 0 = sin límite
     double penaltyWeight = 1000.0; // peso para penalizar violación de varianza
+    double targetEnergy = -1.0;    // energía objetivo para medir el tiempo en alcanzarla; < 0 = sin objetivo
+    int traceInterval = 0;         // iteraciones entre muestras de la traza (T, energía, mejor); 0 = sin traza
+
+    // Programa de temperaturas (ver CoolingSchedule): "geometric", "geometric_time" o "lam"
+    std::string schedule = "geometric";
+    bool autoT0 = false;            // estimar T0 a partir de movimientos cuesta arriba
+    double autoT0Acceptance = 0.8;  // probabilidad de aceptar el empeoramiento medio a T0
+    int autoT0Samples = 200;        // movimientos muestreados para la estimación
+    double reheatStagnation = 0.0;  // fracción del presupuesto sin mejorar antes de recalentar; 0 = nunca
+    double reheatFactor = 10.0;     // multiplicador de T al recalentar
+
+    // Solución de partida (ver buildSeededSolution): "random", "variance", "beam", "kmeans" o "dp"
+    std::string seeding = "random";
+    int seedBeamWidth = 8; // estados que conserva la búsqueda en haz
+    int seedBeamCuts = 3;  // mejores cortes de cada rectángulo que se expanden
+
+    // Reinicios independientes en paralelo (ver parallelSimulatedAnnealing)
+    int chains = 1;                // nº de cadenas de SA independientes
+    int threads = 0;               // hilos del pool; 0 = núcleos disponibles
+    double totalTimeSeconds = 0.0; // presupuesto total de reloj; 0 = maxTimeSeconds por cadena
+
+    unsigned long long seed = 0;   // semilla de los generadores; 0 = aleatoria (main la resuelve y la registra)
+
+    // Motor de búsqueda: "sa" (cadenas independientes), "pyramid" (cadenas independientes,
+    // cada una de lo grueso a lo fino, ver multiResolutionAnnealing), "tempering" (replica
+    // exchange), "islands" (cadenas que comparten la mejor solución, ver islandAnnealing)
+    // o "dp" (programación dinámica exacta sobre particiones guillotina, ver guillotineDP)
+    std::string mode = "sa";
+
+    // Pipeline multirresolución (mode "pyramid")
+    int pyramidLevels = 0;         // niveles reducidos (cada uno a la mitad del anterior); 0 = automático
+    int pyramidMinSide = 32;       // (automático) lado menor mínimo del nivel más grueso
+    double pyramidFineShare = 0.4; // fracción del presupuesto para la resolución completa; el resto, por partes iguales
+    double pyramidRefineT0 = 0.05; // T0 de los niveles de refinamiento relativa a la del nivel más grueso
+
+    // Parallel tempering (ver parallelTempering)
+    int ptReplicas = 8;                  // nº de escalones (una réplica y un hilo por escalón)
+    double ptTMin = 1.0;                 // temperatura del escalón más frío
+    double ptTMax = 1000.0;              // temperatura del escalón más caliente
+    std::string ptSpacing = "geometric"; // "geometric" o "linear"
+    int ptSwapInterval = 100;            // iteraciones entre intentos de intercambio
+
+    // Modelo de islas (mode "islands")
+    int islands = 4;                    // nº de islas (un hilo por isla)
+    int islandMigrationInterval = 1000; // iteraciones entre intentos de publicar o adoptar
+    int islandStagnation = 20000;       // iteraciones sin mejorar antes de adoptar/cruzar con la mejor global
+    double islandCrossoverRate = 0.5;   // probabilidad de cruzar (en vez de adoptar) al migrar
+
+    // Operadores de vecindario (ver MoveOperatorSet); peso 0 = deshabilitado
+    double opBorderWeight = 1.0;     // una fila/columna entre dos zonas
+    double opSlideWeight = 1.0;      // deslizar un corte guillotina
+    double opMergeSplitWeight = 0.5; // fusionar dos zonas y partir otra
+    double opRecutWeight = 1.0;      // volver a cortar un par de zonas
+    int opSlideMaxCells = 3;         // desplazamiento máximo del corte por movimiento
+    bool opAdaptive = true;          // adaptar las probabilidades a la tasa de aceptación
+    int opAdaptInterval = 1000;      // movimientos entre reajustes
+    double opMinProbability = 0.05;  // probabilidad mínima de cada operador habilitado
+
+    // Programación dinámica (mode "dp")
+    int dpCutStride = 1;               // los cortes caen en filas/columnas múltiplos de este paso; 1 = óptimo exacto
+    long long dpMaxStates = 20000000;  // tope de pares (rectángulo, k) de la tabla (~16 bytes cada uno)
 };
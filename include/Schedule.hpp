@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include "Random.hpp"
+#include "SAConfig.hpp"
+
+class AnnealingChain;
+
+// Programa de temperaturas de una cadena de SA. Según cfg.schedule:
+//  - "geometric":      T *= coolingFactor cada itersPerTemp iteraciones hasta Tf,
+//                      maxIterations o maxTimeSeconds (comportamiento original).
+//  - "geometric_time": T baja geométricamente de T0 a Tf a lo largo del presupuesto
+//                      de tiempo, sin depender de cuántas iteraciones quepan en él.
+//  - "lam":            Modified Lam: T se ajusta (dentro de [Tf, T0]) para seguir una
+//                      tasa de aceptación objetivo que depende de la fracción de
+//                      tiempo transcurrida.
+// Con reheatStagnation > 0, si la mejor solución no mejora durante esa fracción del
+// presupuesto la temperatura se multiplica por reheatFactor (sin superar T0). El
+// presupuesto es maxTimeSeconds o, si es 0, maxIterations.
+class CoolingSchedule
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CoolingSchedule(const SAConfig &cfg, double initialTemperature, Clock::time_point start);
+
+    double temperature() const { return T; }
+    bool finished() const;
+
+    // Informa el resultado de la última iteración.
+    void observe(bool accepted, bool improvedBest);
+
+    long long iterations() const { return iterCount; }
+    int reheats() const { return reheatCount; }
+    double acceptanceRate() const { return acceptRate; }
+
+private:
+    void refreshClock();
+
+    enum class Kind
+    {
+        Geometric,
+        GeometricTime,
+        Lam
+    };
+
+    Kind kind = Kind::Geometric;
+    double T0 = 1.0;
+    double Tf = 0.0;
+    double T = 1.0;
+    double coolingFactor = 0.95;
+    int itersPerTemp = 100;
+    long long maxIterations = 0;
+    double budgetSeconds = 0.0;
+    Clock::time_point startTime;
+
+    long long iterCount = 0;
+    double fraction = 0.0;   // fracción del presupuesto (tiempo o, sin él, iteraciones) consumida; se refresca cada pocas iteraciones
+    double acceptRate = 0.5; // media móvil exponencial de la aceptación (Lam)
+
+    // Curva geométrica actual (geometric_time): T = segStartT * (Tf / segStartT)^((f - segStartF) / (1 - segStartF)).
+    double segStartT = 1.0;
+    double segStartF = 0.0;
+
+    double reheatStagnation = 0.0;
+    double reheatFactor = 10.0;
+    double lastImprovementF = 0.0;
+    int reheatCount = 0;
+};
+
+// Estima T0 de modo que un movimiento cuesta arriba medio se acepte con probabilidad
+// cfg.autoT0Acceptance: T0 = -mean(Δ+) / ln(χ0), con Δ+ muestreados desde la solución
+// actual de la cadena (sin modificarla). Si ningún movimiento empeora, devuelve cfg.T0.
+double estimateInitialTemperature(AnnealingChain &chain, const SAConfig &cfg, Rng &rng);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "IntegralImage.hpp"
+#include "ProblemInstance.hpp"
+#include "Random.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Solución de partida según cfg.seeding (todas son particiones guillotina en p rectángulos):
+//  - "random":   cortes uniformes sobre el rectángulo de mayor área (buildInitialSolution)
+//  - "variance": corta el rectángulo de mayor energía de zona (SSE + penalización ponderada)
+//                en la posición que minimiza la energía de las dos partes
+//  - "beam":     búsqueda en haz de ancho cfg.seedBeamWidth; cada estado se expande con los
+//                cfg.seedBeamCuts mejores cortes de cada uno de sus rectángulos
+//  - "kmeans":   k-means 1D (k = p, centros iniciales en cuantiles con desplazamiento
+//                aleatorio) sobre los valores de S; la grilla con cada celda reemplazada por
+//                el centro de su grupo se parte como en "variance" (solo SSE), de modo que
+//                los cortes siguen los bordes entre grupos
+//  - "dp":       óptimo guillotina por programación dinámica (guillotineDP, un hilo)
+// Solo "random" y "kmeans" usan el generador; las demás son deterministas.
+Solution buildSeededSolution(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg, Rng &rng);
+
+// true con las estrategias deterministas ("variance", "beam", "dp"): todas las cadenas
+// obtendrían la misma partición, así que los drivers la calculan una sola vez con
+// buildSharedSeed (la DP con cfg.threads hilos) y la pasan a cada cadena.
+bool isSharedSeeding(const SAConfig &cfg);
+Solution buildSharedSeed(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg);
@@ -2,22 +2,46 @@
 
 #include <random>
 #include <vector>
+#include "Grid.hpp"
+#include "IntegralImage.hpp"
+#include "Move.hpp"
 #include "ProblemInstance.hpp"
+#include "Random.hpp"
+#include "Rect.hpp"
 
 // Representa una solución del SPP:
-//  - Z: matriz de etiquetas de zonas (1..p)
+//  - rects: rectángulo de cada zona (zona k = rects[k - 1], k = 1..p)
 //  - errorTotal: valor de la función objetivo (suma de errores cuadrados)
+// La matriz de etiquetas Z solo se materializa bajo demanda (ver buildLabelGrid).
 struct Solution
 {
-    std::vector<std::vector<int>> Z;
+    std::vector<Rect> rects;
     double errorTotal = 0.0;
 };
 
+// Movimiento de borde: las celdas de 'strip' pasan de la zona 'from' a la zona 'to'.
+struct BorderMove
+{
+    int from = 0;
+    int to = 0;
+    Rect strip;
+};
+
 // Crea una solución inicial por cortes guillotina aleatorios (rectangulos).
 Solution buildInitialSolution(const ProblemInstance &instance);
 
+// Igual que la anterior usando el generador indicado.
+Solution buildInitialSolution(const ProblemInstance &instance, Rng &rng);
+
+// Materializa la matriz de etiquetas Z (N x M, valores 1..p) de una partición en rectángulos.
+Grid<int> buildLabelGrid(const ProblemInstance &instance, const std::vector<Rect> &rects);
+
 // Calcula medias, varianzas y error total de la asignación Z.
-double calculateErrorAndVariance(const ProblemInstance &instance, const std::vector<std::vector<int>> &Z, std::vector<double> &means, std::vector<double> &variances, std::vector<int> &counts);
+double calculateErrorAndVariance(const ProblemInstance &instance, const Grid<int> &Z, std::vector<double> &means, std::vector<double> &variances, std::vector<int> &counts);
+
+// Igual que la anterior pero para una partición en rectángulos (zona k = rects[k - 1]).
+// Usa la tabla de sumas acumuladas, por lo que cuesta O(p) en vez de O(N·M).
+double calculateErrorAndVariance(const ProblemInstance &instance, const IntegralImage &integral, const std::vector<Rect> &rects, std::vector<double> &means, std::vector<double> &variances, std::vector<int> &counts);
 
 // Penaliza el exceso de varianza respecto de alpha * Var(S) para cada zona.
 double calculateVariancePenalty(const ProblemInstance &instance, const std::vector<double> &variances, const std::vector<int> &counts, double totalVariance);
@@ -26,14 +50,43 @@ double calculateVariancePenalty(const ProblemInstance &instance, const std::vect
 double calculateTotalVariance(const ProblemInstance &instance);
 
 // Verifica homogeneidad y conexidad de todas las zonas.
-bool isSolutionValid(const ProblemInstance &instance, const std::vector<std::vector<int>> &Z, double totalVariance);
+bool isSolutionValid(const ProblemInstance &instance, const Grid<int> &Z, double totalVariance);
+
+// Igual que la anterior para una partición en rectángulos; no recorre la grilla.
+bool isSolutionValid(const ProblemInstance &instance, const IntegralImage &integral, const std::vector<Rect> &rects, double totalVariance);
 
 // Verifica solo conexidad (polígono válido) y que no existan zonas vacías.
-bool isPartitionConnected(const ProblemInstance &instance, const std::vector<std::vector<int>> &Z);
+// Recorre la grilla con BFS; se conserva como referencia (ver SPP_DEBUG_CHECKS).
+bool isPartitionConnected(const ProblemInstance &instance, const Grid<int> &Z);
+
+// Verifica que los p rectángulos sean no vacíos, no se solapen y cubran exactamente la grilla.
+// Cuesta O(p log p) y no recorre la grilla.
+bool isPartitionConnected(const ProblemInstance &instance, const std::vector<Rect> &rects);
+
+// Igual que la anterior reutilizando 'corners' como buffer (4p vértices), para no reservar
+// memoria en cada iteración.
+bool isPartitionConnected(const ProblemInstance &instance, const std::vector<Rect> &rects, std::vector<unsigned long long> &corners);
 
 // Intenta reparar zonas a rectángulos no superpuestos. Devuelve true si pudo.
-bool makeRectsIfNonOverlapping(const ProblemInstance &instance, std::vector<std::vector<int>> &Z);
+bool makeRectsIfNonOverlapping(const ProblemInstance &instance, Grid<int> &Z);
+
+// Igual que la anterior; además devuelve el rectángulo de cada zona (zona k = rects[k - 1]).
+bool makeRectsIfNonOverlapping(const ProblemInstance &instance, Grid<int> &Z, std::vector<Rect> &rects);
 
 // Genera un vecino moviendo un borde completo cuando es posible.
 // Devuelve true si se generó un vecino distinto de la solución actual.
-bool generateNeighbor(const ProblemInstance &instance, const std::vector<std::vector<int>> &currentZ, std::vector<std::vector<int>> &neighborZ, std::mt19937 &rng);
+bool generateNeighbor(const ProblemInstance &instance, const Grid<int> &currentZ, Grid<int> &neighborZ, Rng &rng);
+
+// Igual que la anterior; además informa qué franja se transfirió y entre qué zonas,
+// lo que permite evaluar el vecino de forma incremental (ver EnergyTracker).
+bool generateNeighbor(const ProblemInstance &instance, const Grid<int> &currentZ, Grid<int> &neighborZ, Rng &rng, BorderMove &move);
+
+// Versión sobre la lista de rectángulos: solo propone movimientos en que ambas zonas
+// comparten el borde completo, de modo que el vecino sigue siendo una partición en
+// rectángulos sin necesidad de reparación. Trabaja en O(p) y sin reservar memoria
+// si neighbor ya tiene capacidad para p rectángulos.
+bool generateNeighbor(const ProblemInstance &instance, const std::vector<Rect> &current, std::vector<Rect> &neighbor, Rng &rng, BorderMove &move);
+
+// Igual que la anterior pero sin copiar la solución: describe el movimiento en 'move'
+// para aplicarlo in situ con applyMove y deshacerlo con undoMove si se rechaza.
+bool proposeBorderMove(const ProblemInstance &instance, const std::vector<Rect> &current, Rng &rng, Move &move);
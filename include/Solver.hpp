@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+#include "GuillotineDP.hpp"
+#include "ProblemInstance.hpp"
+#include "SA.hpp"
+#include "SAConfig.hpp"
+#include "Solution.hpp"
+
+// Resuelve la instancia con el método que indica cfg.mode: "dp" (guillotineDP),
+// "tempering" (parallelTempering), "islands" (islandAnnealing) o, con "sa" y "pyramid",
+// parallelSimulatedAnnealing. Es el único punto de despacho, compartido por main y el
+// modo batch. chainStats e initialOut como en parallelSimulatedAnnealing; dpStats solo
+// se completa con mode "dp".
+Solution solveInstance(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *chainStats = nullptr, Solution *initialOut = nullptr, DPStats *dpStats = nullptr);
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Telemetría de una cadena de SA. Los contadores son incrementos de enteros y están
+// siempre activos; el desglose del tiempo por fase dentro de cada iteración (proponer,
+// evaluar, confirmar/deshacer) lee el reloj varias veces por iteración, así que solo se
+// compila con SPP_TELEMETRY (make TELEMETRY=1). Sin esa macro los campos quedan en 0.
+
+// Tiempo acumulado por fase del paso de Metropolis (solo con SPP_TELEMETRY).
+struct StepPhaseTimes
+{
+    double proposeSeconds = 0.0;  // elegir operador y describir el movimiento
+    double evaluateSeconds = 0.0; // aplicar in situ y calcular la variación de energía
+    double commitSeconds = 0.0;   // confirmar (energía, adyacencias, mejor) o deshacer
+};
+
+// Cronómetro por vueltas para el bucle caliente: lap() suma el tiempo desde la vuelta
+// anterior al acumulador indicado. Sin SPP_TELEMETRY es vacío y el compilador lo elimina.
+class PhaseStopwatch
+{
+public:
+#ifdef SPP_TELEMETRY
+    PhaseStopwatch() : last(Clock::now()) {}
+
+    void lap(double &accumulator)
+    {
+        const Clock::time_point now = Clock::now();
+        accumulator += std::chrono::duration<double>(now - last).count();
+        last = now;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point last;
+#else
+    void lap(double &) {}
+#endif
+};
+
+// Búsqueda de la solución de partida (buildStartingSolution): movimientos de borde
+// intentados hasta encontrar una partición que cumpla las restricciones.
+struct StartTelemetry
+{
+    bool initialValid = false; // la partición por cortes guillotina ya era válida
+    int attempts = 0;          // movimientos de reparación intentados
+    int neighborFailures = 0;  // generateNeighbor no encontró un movimiento
+    int invalidRejects = 0;    // vecinos descartados por homogeneidad/conexidad
+};
+
+// Muestra de la traza periódica (cada cfg.traceInterval iteraciones).
+struct TraceSample
+{
+    double seconds = 0.0;
+    long long iteration = 0;
+    double temperature = 0.0;
+    double energy = 0.0;
+    double bestEnergy = 0.0;
+};
+
+// Uso de cada operador de vecindario al final de la ejecución.
+struct OperatorTelemetry
+{
+    std::string name;
+    long long attempts = 0;
+    long long accepted = 0;
+    double probability = 0.0; // probabilidad de selección final
+};
+
+// Un nivel del pipeline multirresolución (ver multiResolutionAnnealing), del más grueso
+// a la resolución completa. Las energías de cada nivel están en la escala de su grilla.
+struct LevelTelemetry
+{
+    int rows = 0;
+    int cols = 0;
+    int factor = 1; // celdas originales por lado de cada celda del nivel
+    long long iterations = 0;
+    double initialEnergy = 0.0;
+    double bestEnergy = 0.0;
+    double seconds = 0.0;
+};
+
+// Migraciones de una isla (ver islandAnnealing).
+struct MigrationTelemetry
+{
+    long long publishes = 0;  // veces que publicó su mejor solución en la ranura compartida
+    long long adoptions = 0;  // veces que reemplazó su solución actual por la mejor global
+    long long crossovers = 0; // veces que cruzó su solución actual con la mejor global
+    long long busy = 0;       // publicaciones o lecturas descartadas porque otro hilo escribía
+};
+
+struct SATelemetry
+{
+    // Contadores del bucle principal. En la representación por rectángulos los operadores
+    // solo proponen movimientos que conservan el mosaico, de modo que no hay rechazos por
+    // conexidad ni reparaciones dentro del bucle: esos rechazos solo ocurren en 'start'.
+    long long proposals = 0;         // iteraciones que pidieron un movimiento
+    long long proposalFailures = 0;  // ningún operador encontró un movimiento aplicable
+    long long metropolisAccepts = 0;
+    long long metropolisRejects = 0;
+    long long improvements = 0;      // veces que mejoró la mejor solución
+
+    StartTelemetry start;
+
+    // Tiempo por etapa de la ejecución (siempre activo: se mide una vez por etapa).
+    double setupSeconds = 0.0; // varianza total y tabla de sumas acumuladas
+    double startSeconds = 0.0; // solución de partida
+    double t0Seconds = 0.0;    // estimación de T0 (autoT0)
+    double loopSeconds = 0.0;  // bucle de Metropolis
+
+    StepPhaseTimes phases; // desglose del bucle (solo con SPP_TELEMETRY)
+
+    std::vector<OperatorTelemetry> operators;
+    std::vector<TraceSample> trace;
+    std::vector<LevelTelemetry> levels; // solo en mode "pyramid"
+    MigrationTelemetry migration;       // solo en mode "islands"
+};
+
+// true si el binario se compiló con el desglose por fase (SPP_TELEMETRY).
+constexpr bool telemetryPhasesEnabled()
+{
+#ifdef SPP_TELEMETRY
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de hilos con robo de trabajo: cada hilo tiene su propia cola; toma tareas
+// del final de la suya (LIFO) y, si está vacía, roba del principio de las demás.
+// Las tareas pueden enviar nuevas tareas; estas van a la cola del hilo que las envía.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(int threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void submit(Task task);
+
+    // Espera a que terminen todas las tareas enviadas (incluidas las anidadas).
+    // Relanza la primera excepción que haya escapado de una tarea.
+    void wait();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popLocal(int self, Task &task);
+    bool steal(int self, Task &task);
+    void run(int self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<long long> queued{0};  // tareas en alguna cola
+    std::atomic<long long> pending{0}; // tareas enviadas y no terminadas
+    std::atomic<unsigned> nextQueue{0};
+    bool stopping = false;
+
+    std::mutex sleepMutex;
+    std::condition_variable workCv;
+    std::condition_variable idleCv;
+    std::exception_ptr error;
+};
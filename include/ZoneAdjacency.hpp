@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <random>
+#include <vector>
+#include "Move.hpp"
+#include "Random.hpp"
+#include "Rect.hpp"
+
+// Índice de adyacencias de una partición en rectángulos: para cada zona y lado
+// (0: superior, 1: inferior, 2: izquierdo, 3: derecho) guarda las zonas vecinas y el
+// tramo de borde que comparten. A partir de él mantiene la lista de movimientos de
+// borde factibles (dos zonas que comparten el lado completo y la que cede conserva
+// al menos una fila/columna), de modo que proponer un movimiento es O(1) y nunca se
+// descarta un intento.
+//
+// Tras aceptar un movimiento basta con update(): solo se recalculan las zonas que
+// cambiaron y sus vecinas previas, que son las únicas cuyas adyacencias pueden variar
+// mientras el movimiento conserve la unión de los rectángulos que modifica.
+class ZoneAdjacency
+{
+public:
+    // Vecina a través de un lado; [from, to] es el tramo compartido (columnas en los lados
+    // superior/inferior, filas en los laterales).
+    struct Neighbor
+    {
+        int zone = 0;
+        int from = 0;
+        int to = 0;
+    };
+
+    // La zona 'receiver' avanza su lado 'side' una fila/columna sobre 'giver'.
+    struct EdgeMove
+    {
+        int giver = 0;
+        int receiver = 0;
+        int side = 0;
+    };
+
+    // Reconstruye el índice desde cero (zona k = rects[k - 1]); cuesta O(p²).
+    void reset(const std::vector<Rect> &rects);
+
+    // Actualiza el índice después de aplicar 'move' sobre rects (ver applyMove).
+    void update(const std::vector<Rect> &rects, const Move &move);
+
+    const std::vector<Neighbor> &neighbors(int zone, int side) const { return sides[zone][side]; }
+    const std::vector<EdgeMove> &feasibleMoves() const { return moves; }
+
+    // Elige al azar un movimiento factible y lo describe en 'move'. Devuelve false solo si
+    // no existe ninguno (p.ej. p = 1).
+    bool proposeBorderMove(const std::vector<Rect> &rects, Rng &rng, Move &move) const;
+
+private:
+    void link(const std::vector<Rect> &rects, int zone, int other, bool mirror);
+    void addMovesOf(const std::vector<Rect> &rects, int zone);
+
+    std::vector<std::array<std::vector<Neighbor>, 4>> sides; // índice 1..p
+    std::vector<EdgeMove> moves;
+
+    // Buffers de update(), reutilizados entre llamadas.
+    std::vector<unsigned> changedStamp;
+    std::vector<unsigned> candidateStamp;
+    std::vector<int> candidates;
+    unsigned epoch = 0;
+};
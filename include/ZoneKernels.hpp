@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Grid.hpp"
+
+// Núcleos vectorizados para los recorridos completos de la grilla (solución inicial,
+// validación, reporte final). La implementación (AVX-512, AVX2 o escalar) se elige una
+// sola vez en tiempo de ejecución según la CPU; la variable de entorno SPP_SIMD
+// (scalar | avx2 | avx512) permite forzar una más baja para comparar.
+//
+// En vez de acumular celda a celda indexando por Z[i][j], cada fila se recorre por
+// tramos de etiqueta constante: cada tramo es un bloque contiguo de S que se suma con
+// instrucciones SIMD y se acumula una sola vez en su zona.
+namespace ZoneKernels
+{
+    // Nombre de la implementación activa ("avx512", "avx2" o "scalar").
+    const char *activeIsa();
+
+    // sums[k] += suma de S en la zona k; counts[k] += celdas de la zona k.
+    // Los arreglos deben tener al menos (máxima etiqueta + 1) posiciones.
+    void accumulateZoneSums(const Grid<double> &S, const Grid<int> &Z, double *sums, int *counts);
+
+    // sse[k] += suma de (S - means[k])² sobre la zona k.
+    void accumulateZoneDeviations(const Grid<double> &S, const Grid<int> &Z, const double *means, double *sse);
+
+    // Suma y suma de cuadrados de toda la grilla.
+    void gridSumAndSquares(const Grid<double> &S, double &sum, double &sumSq);
+}
@@ -0,0 +1,169 @@
+#include "AnnealingChain.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "Seeding.hpp"
+
+AnnealingChain::AnnealingChain(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg)
+    : instance(instance),
+      integral(integral),
+      tracker(instance, totalVariance, cfg.penaltyWeight),
+      operatorSet(cfg)
+{
+    // Buffers dimensionados una sola vez: step() no reserva memoria.
+    currentSol.rects.reserve(instance.p);
+    bestSol.rects.reserve(instance.p);
+    move.changes.reserve(instance.p);
+    corners.reserve(4 * static_cast<size_t>(instance.p));
+}
+
+void AnnealingChain::reset(const Solution &start)
+{
+    currentSol.rects.assign(start.rects.begin(), start.rects.end());
+    tracker.reset(integral, currentSol.rects);
+    adjacency.reset(currentSol.rects);
+    currentSol.errorTotal = tracker.error();
+    bestSol = currentSol;
+    bestE = tracker.energy();
+}
+
+void AnnealingChain::restart(const Solution &start)
+{
+    currentSol.rects.assign(start.rects.begin(), start.rects.end());
+    tracker.reset(integral, currentSol.rects);
+    adjacency.reset(currentSol.rects);
+    currentSol.errorTotal = tracker.error();
+    if (tracker.energy() < bestE)
+    {
+        bestSol = currentSol;
+        bestE = tracker.energy();
+    }
+}
+
+bool AnnealingChain::step(double temperature, Rng &rng)
+{
+    ++iterCount;
+    PhaseStopwatch watch;
+
+    // Los operadores solo proponen movimientos factibles (ver MoveOperatorSet); el movimiento
+    // se aplica in situ sobre la solución actual y se deshace si se rechaza.
+    const bool proposed = operatorSet.propose(currentSol.rects, adjacency, rng, move);
+    watch.lap(phaseTimes.proposeSeconds);
+    if (!proposed)
+    {
+        ++proposalFailCount;
+        return false;
+    }
+    applyMove(currentSol.rects, move);
+
+#ifdef SPP_DEBUG_CHECKS
+    if (!isPartitionConnected(instance, currentSol.rects, corners))
+    {
+        throw std::runtime_error("AnnealingChain::step: el movimiento propuesto no conserva el mosaico");
+    }
+#endif
+
+    // Solo cambian las zonas del movimiento: su energía sale de la tabla de sumas.
+    double delta = tracker.moveDelta(integral, move);
+    watch.lap(phaseTimes.evaluateSeconds);
+
+    bool accept = false;
+    if (delta < 0)
+    {
+        accept = true;
+    }
+    else
+    {
+        double prob = std::exp(-delta / temperature);
+        accept = uniform01(rng) < prob;
+    }
+
+    operatorSet.record(accept);
+    if (!accept)
+    {
+        undoMove(currentSol.rects, move);
+        watch.lap(phaseTimes.commitSeconds);
+        return false;
+    }
+
+    ++acceptCount;
+    tracker.applyMove(integral, move);
+    adjacency.update(currentSol.rects, move);
+    currentSol.errorTotal = tracker.error();
+
+    if (tracker.energy() < bestE)
+    {
+        bestSol = currentSol;
+        bestE = tracker.energy();
+        ++improveCount;
+    }
+    watch.lap(phaseTimes.commitSeconds);
+    return true;
+}
+
+void AnnealingChain::fillTelemetry(SATelemetry &telemetry) const
+{
+    telemetry.proposals = iterCount;
+    telemetry.proposalFailures = proposalFailCount;
+    telemetry.metropolisAccepts = acceptCount;
+    telemetry.metropolisRejects = iterCount - proposalFailCount - acceptCount;
+    telemetry.improvements = improveCount;
+    telemetry.phases = phaseTimes;
+
+    telemetry.operators.clear();
+    for (size_t i = 0; i < operatorSet.size(); ++i)
+    {
+        telemetry.operators.push_back({operatorSet.name(i), operatorSet.attempts(i), operatorSet.accepted(i), operatorSet.probability(i)});
+    }
+}
+
+bool AnnealingChain::sampleDelta(Rng &rng, double &delta)
+{
+    if (!operatorSet.propose(currentSol.rects, adjacency, rng, move))
+    {
+        return false;
+    }
+    delta = tracker.moveDelta(integral, move);
+    return true;
+}
+
+Solution buildStartingSolution(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg, Rng &rng, StartTelemetry *telemetry, const Solution *seed)
+{
+    Solution current = seed ? *seed : buildSeededSolution(instance, integral, totalVariance, cfg, rng);
+    StartTelemetry local;
+    StartTelemetry &counters = telemetry ? *telemetry : local;
+    counters = StartTelemetry{};
+
+    // Intentar encontrar una solución inicial válida si la partición por franjas no cumple restricciones
+    counters.initialValid = isSolutionValid(instance, integral, current.rects, totalVariance);
+    if (!counters.initialValid)
+    {
+        std::vector<Rect> neighborRects;
+        neighborRects.reserve(instance.p);
+        BorderMove border;
+        for (int attempt = 0; attempt < 1000; ++attempt)
+        {
+            ++counters.attempts;
+            if (!generateNeighbor(instance, current.rects, neighborRects, rng, border))
+            {
+                ++counters.neighborFailures;
+                continue;
+            }
+            if (!isSolutionValid(instance, integral, neighborRects, totalVariance))
+            {
+                ++counters.invalidRejects;
+            }
+            else
+            {
+                std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
+                std::vector<int> counts(instance.p + 1, 0);
+                current.errorTotal = calculateErrorAndVariance(instance, integral, neighborRects, means, variances, counts);
+                current.rects = neighborRects;
+                break;
+            }
+        }
+    }
+
+    return current;
+}
@@ -0,0 +1,213 @@
+#include "Batch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "IO.hpp"
+#include "Solver.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace
+{
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Nombre de salida: {instancia}_p{p}_a{alpha}, para que una misma instancia pueda
+    // aparecer varias veces en el manifiesto con parámetros distintos.
+    std::string outputNameFor(const BatchJob &job)
+    {
+        std::ostringstream name;
+        name << std::filesystem::path(job.instancePath).stem().string() << "_p" << job.p << "_a" << job.alpha;
+        return name.str();
+    }
+}
+
+std::vector<BatchJob> readBatchManifest(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        throw std::runtime_error("No se pudo abrir el manifiesto: " + path);
+    }
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNo;
+        line = line.substr(0, line.find('#'));
+        std::istringstream ls(line);
+        std::string instance;
+        if (!(ls >> instance))
+        {
+            continue; // línea vacía o comentario
+        }
+
+        BatchJob job;
+        if (!(ls >> job.p >> job.alpha) || job.p <= 0 || job.alpha <= 0.0 || job.alpha > 1.0)
+        {
+            throw std::runtime_error("Linea " + std::to_string(lineNo) + " invalida en " + path + " (se espera: instancia p alpha, con p > 0 y alpha en ]0,1])");
+        }
+        job.instancePath = IO::resolveInstancePath(instance);
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+std::vector<BatchResult> runBatch(const std::vector<BatchJob> &jobs, const SAConfig &cfg, const std::string &outputDir, OutputQueue *output, const BatchRenderHook &render)
+{
+    std::filesystem::create_directories(outputDir);
+
+    int threads = cfg.threads > 0 ? cfg.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, static_cast<int>(jobs.size())));
+
+    // Cada trabajo resuelve sus cadenas en serie; el paralelismo está entre trabajos.
+    SAConfig jobCfg = cfg;
+    jobCfg.threads = 1;
+
+    // Sin etapa de salida compartida se usa una propia: un hilo de E/S y una cola del
+    // tamaño del pool, suficiente para que ningún solver espere a la escritura de otro.
+    std::unique_ptr<OutputQueue> ownOutput;
+    if (!output)
+    {
+        ownOutput = std::make_unique<OutputQueue>(1, static_cast<std::size_t>(threads) * 2);
+        output = ownOutput.get();
+    }
+
+    std::vector<BatchResult> results(jobs.size());
+    std::mutex errorMutex; // res.error también lo escribe la etapa de salida
+    WorkStealingPool pool(threads);
+
+    for (size_t idx = 0; idx < jobs.size(); ++idx)
+    {
+        // Tarea de carga: al terminar encola la resolución en la cola del mismo hilo (que la
+        // toma a continuación), mientras los hilos libres roban las cargas pendientes.
+        pool.submit([&, idx]() {
+            BatchResult &res = results[idx];
+            res.job = jobs[idx];
+            res.outputName = outputNameFor(res.job);
+
+            auto instance = std::make_shared<ProblemInstance>();
+            const auto loadStart = std::chrono::steady_clock::now();
+            try
+            {
+                *instance = IO::readInstanceFromFile(res.job.instancePath);
+            }
+            catch (const std::exception &ex)
+            {
+                res.error = ex.what();
+                return;
+            }
+            instance->p = res.job.p;
+            instance->alpha = res.job.alpha;
+            res.nRows = instance->nRows;
+            res.nCols = instance->nCols;
+            res.loadSeconds = secondsSince(loadStart);
+
+            pool.submit([&, idx, instance]() {
+                BatchResult &res = results[idx];
+                const auto solveStart = std::chrono::steady_clock::now();
+                try
+                {
+                    Solution initial;
+                    std::vector<SAStats> chainStats;
+                    // Con semilla fija, cada trabajo usa una semilla propia y reproducible.
+                    SAConfig cfgForJob = jobCfg;
+                    if (cfgForJob.seed != 0)
+                    {
+                        cfgForJob.seed += idx;
+                    }
+                    Solution best = solveInstance(*instance, cfgForJob, &chainStats, &initial);
+
+                    res.errorTotal = best.errorTotal;
+                    res.energy = chainStats.front().bestEnergy;
+                    for (const SAStats &st : chainStats)
+                    {
+                        res.energy = std::min(res.energy, st.bestEnergy);
+                        res.iterations += st.iterations;
+                    }
+                    res.solveSeconds = secondsSince(solveStart);
+
+                    // Las matrices de etiquetas, los archivos y el render quedan fuera del camino crítico.
+                    const std::string prefix = (std::filesystem::path(outputDir) / res.outputName).string();
+                    output->submit([&, idx, instance, prefix, seed = cfgForJob.seed, jobCfg = cfgForJob,
+                                    initial = std::move(initial), best = std::move(best), chainStats = std::move(chainStats)]() {
+                        try
+                        {
+                            IO::writeSolutionToFile(prefix + "_initial.out", initial.errorTotal, *instance, buildLabelGrid(*instance, initial.rects), seed);
+                            IO::writeSolutionToFile(prefix + "_best.out", best.errorTotal, *instance, buildLabelGrid(*instance, best.rects), seed);
+                            IO::writeStatsToJson(prefix + "_best.stats.json", chainStats, jobCfg);
+                            if (render && !best.rects.empty())
+                            {
+                                render(*instance, best.rects, prefix + "_best.out");
+                            }
+                        }
+                        catch (const std::exception &ex)
+                        {
+                            std::lock_guard<std::mutex> lock(errorMutex);
+                            results[idx].error = ex.what();
+                        }
+                    });
+                }
+                catch (const std::exception &ex)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    res.error = ex.what();
+                    res.solveSeconds = secondsSince(solveStart);
+                }
+            });
+        });
+    }
+
+    // Las salidas encoladas usan 'results': hay que esperarlas también si algo falló.
+    try
+    {
+        pool.wait();
+    }
+    catch (...)
+    {
+        output->flush();
+        throw;
+    }
+    output->flush();
+    writeBatchSummary((std::filesystem::path(outputDir) / "summary.csv").string(), results);
+    return results;
+}
+
+void writeBatchSummary(const std::string &path, const std::vector<BatchResult> &results)
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        throw std::runtime_error("No se pudo abrir el archivo de resumen: " + path);
+    }
+
+    out << "instance,p,alpha,rows,cols,energy,error_total,iterations,load_seconds,solve_seconds,status\n";
+    for (const BatchResult &r : results)
+    {
+        out << r.job.instancePath << ',' << r.job.p << ',' << r.job.alpha << ','
+            << r.nRows << ',' << r.nCols << ',' << r.energy << ',' << r.errorTotal << ','
+            << r.iterations << ',' << r.loadSeconds << ',' << r.solveSeconds << ',';
+        if (r.error.empty())
+        {
+            out << "ok";
+        }
+        else
+        {
+            std::string msg = r.error;
+            std::replace(msg.begin(), msg.end(), ',', ';');
+            out << "error: " << msg;
+        }
+        out << '\n';
+    }
+}
@@ -0,0 +1,105 @@
+#include "EnergyTracker.hpp"
+
+#include <algorithm>
+
+EnergyTracker::EnergyTracker(const ProblemInstance &instance, double totalVariance, double penaltyWeight)
+    : p(instance.p),
+      maxVariance(instance.alpha * totalVariance),
+      penaltyWeight(penaltyWeight),
+      zones(instance.p + 1)
+{
+}
+
+ZoneStats EnergyTracker::statsOf(const IntegralImage &integral, const Rect &r)
+{
+    return ZoneStats{integral.sum(r), integral.sumSq(r), integral.count(r)};
+}
+
+double EnergyTracker::zoneError(const ZoneStats &z) const
+{
+    if (z.count == 0)
+    {
+        return 0.0;
+    }
+    return std::max(0.0, z.sumSq - z.sum * z.sum / static_cast<double>(z.count));
+}
+
+double EnergyTracker::zonePenalty(const ZoneStats &z) const
+{
+    // Mismo criterio que calculateVariancePenalty.
+    if (z.count == 0)
+    {
+        return maxVariance;
+    }
+    double variance = zoneError(z) / static_cast<double>(z.count);
+    return variance > maxVariance ? variance - maxVariance : 0.0;
+}
+
+void EnergyTracker::reset(const IntegralImage &integral, const std::vector<Rect> &rects)
+{
+    errorTotal = 0.0;
+    penalty = 0.0;
+    for (int k = 1; k <= p; ++k)
+    {
+        zones[k] = k <= static_cast<int>(rects.size()) ? statsOf(integral, rects[k - 1]) : ZoneStats{};
+        errorTotal += zoneError(zones[k]);
+        penalty += zonePenalty(zones[k]);
+    }
+}
+
+double EnergyTracker::transferDelta(int from, int to, const ZoneStats &strip) const
+{
+    const ZoneStats &a = zones[from];
+    const ZoneStats &b = zones[to];
+    ZoneStats a2{a.sum - strip.sum, a.sumSq - strip.sumSq, a.count - strip.count};
+    ZoneStats b2{b.sum + strip.sum, b.sumSq + strip.sumSq, b.count + strip.count};
+
+    double dError = zoneError(a2) + zoneError(b2) - zoneError(a) - zoneError(b);
+    double dPenalty = zonePenalty(a2) + zonePenalty(b2) - zonePenalty(a) - zonePenalty(b);
+    return dError + penaltyWeight * dPenalty;
+}
+
+void EnergyTracker::applyTransfer(int from, int to, const ZoneStats &strip)
+{
+    ZoneStats &a = zones[from];
+    ZoneStats &b = zones[to];
+    errorTotal -= zoneError(a) + zoneError(b);
+    penalty -= zonePenalty(a) + zonePenalty(b);
+
+    a.sum -= strip.sum;
+    a.sumSq -= strip.sumSq;
+    a.count -= strip.count;
+    b.sum += strip.sum;
+    b.sumSq += strip.sumSq;
+    b.count += strip.count;
+
+    errorTotal += zoneError(a) + zoneError(b);
+    penalty += zonePenalty(a) + zonePenalty(b);
+}
+
+double EnergyTracker::moveDelta(const IntegralImage &integral, const Move &move) const
+{
+    double dError = 0.0;
+    double dPenalty = 0.0;
+    for (const RectChange &c : move.changes)
+    {
+        const ZoneStats &old = zones[c.zone];
+        const ZoneStats now = statsOf(integral, c.after);
+        dError += zoneError(now) - zoneError(old);
+        dPenalty += zonePenalty(now) - zonePenalty(old);
+    }
+    return dError + penaltyWeight * dPenalty;
+}
+
+void EnergyTracker::applyMove(const IntegralImage &integral, const Move &move)
+{
+    for (const RectChange &c : move.changes)
+    {
+        ZoneStats &z = zones[c.zone];
+        errorTotal -= zoneError(z);
+        penalty -= zonePenalty(z);
+        z = statsOf(integral, c.after);
+        errorTotal += zoneError(z);
+        penalty += zonePenalty(z);
+    }
+}
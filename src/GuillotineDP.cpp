@@ -0,0 +1,421 @@
+#include "GuillotineDP.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "IntegralImage.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace
+{
+    // Mejor partición conocida de un rectángulo en k zonas: energía y primer corte.
+    struct DPCell
+    {
+        double energy = 0.0;
+        int cut = 0;             // primera fila/columna de la segunda parte; 0 = hoja (k = 1)
+        short kFirst = 0;        // zonas de la primera parte (arriba o izquierda)
+        bool horizontal = false; // corte entre filas (true) o entre columnas (false)
+    };
+
+    std::uint64_t packRect(const Rect &r)
+    {
+        return (static_cast<std::uint64_t>(r.top) << 48) | (static_cast<std::uint64_t>(r.bottom) << 32) |
+               (static_cast<std::uint64_t>(r.left) << 16) | static_cast<std::uint64_t>(r.right);
+    }
+
+    // Tabla hash de direccionamiento abierto (sondeo lineal) rectángulo -> índice.
+    // Se llena una sola vez antes de resolver; después solo se consulta, sin bloqueos.
+    class RectTable
+    {
+    public:
+        explicit RectTable(std::size_t expected)
+        {
+            std::size_t capacity = 16;
+            while (capacity < 2 * expected)
+            {
+                capacity *= 2;
+            }
+            slots.assign(capacity, Slot{});
+            mask = capacity - 1;
+        }
+
+        void insert(std::uint64_t key, int index)
+        {
+            std::size_t pos = hash(key) & mask;
+            while (slots[pos].key != kEmpty)
+            {
+                pos = (pos + 1) & mask;
+            }
+            slots[pos] = Slot{key, index};
+        }
+
+        int find(std::uint64_t key) const
+        {
+            std::size_t pos = hash(key) & mask;
+            while (slots[pos].key != key)
+            {
+                pos = (pos + 1) & mask; // toda clave consultada fue insertada
+            }
+            return slots[pos].index;
+        }
+
+    private:
+        static constexpr std::uint64_t kEmpty = ~0ULL;
+
+        struct Slot
+        {
+            std::uint64_t key = kEmpty;
+            int index = -1;
+        };
+
+        static std::size_t hash(std::uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            return static_cast<std::size_t>(key);
+        }
+
+        std::vector<Slot> slots;
+        std::size_t mask = 0;
+    };
+
+    class GuillotineSolver
+    {
+    public:
+        GuillotineSolver(const ProblemInstance &instance, const SAConfig &cfg)
+            : instance(instance),
+              integral(instance),
+              stride(cfg.dpCutStride),
+              p(instance.p),
+              maxVariance(instance.alpha * calculateTotalVariance(instance)),
+              penaltyWeight(cfg.penaltyWeight),
+              table(0)
+        {
+            if (instance.nRows >= (1 << 16) || instance.nCols >= (1 << 16))
+            {
+                throw std::runtime_error("guillotineDP: la grilla debe tener menos de 65536 filas y columnas");
+            }
+            if (p > std::numeric_limits<short>::max()) // DPCell::kFirst es short
+            {
+                throw std::runtime_error("guillotineDP: p = " + std::to_string(p) + " supera el maximo de " +
+                                         std::to_string(std::numeric_limits<short>::max()) + " zonas");
+            }
+
+            // Límites de corte permitidos (0, s, 2s, ..., N): un rectángulo va de un límite al siguiente.
+            const std::vector<int> rowBounds = boundsOf(instance.nRows);
+            const std::vector<int> colBounds = boundsOf(instance.nCols);
+            const long long rowSegments = static_cast<long long>(rowBounds.size()) - 1;
+            const long long colSegments = static_cast<long long>(colBounds.size()) - 1;
+            if (p < 1 || p > rowSegments * colSegments)
+            {
+                throw std::runtime_error("guillotineDP: p = " + std::to_string(p) + " no cabe en " + std::to_string(rowSegments * colSegments) +
+                                         " bloques con dp_cut_stride = " + std::to_string(stride));
+            }
+
+            // Conteo previo para el tope de memoria. Se corta apenas se supera el tope: con
+            // lados < 65536 cada término entra en long long (placements < 2^32, p < 2^15) y
+            // stateCount nunca pasa de dp_max_states, así que ni la suma ni rectCount desbordan.
+            long long rectCount = 0;
+            long long stateCount = 0;
+            for (long long h = 1; h <= rowSegments; ++h)
+            {
+                for (long long w = 1; w <= colSegments; ++w)
+                {
+                    const long long placements = (rowSegments - h + 1) * (colSegments - w + 1);
+                    const long long states = placements * std::min<long long>(p, h * w);
+                    if (states > cfg.dpMaxStates - stateCount)
+                    {
+                        throw std::runtime_error("guillotineDP: la tabla necesitaria mas de dp_max_states = " + std::to_string(cfg.dpMaxStates) +
+                                                 " estados; aumente dp_cut_stride");
+                    }
+                    rectCount += placements;
+                    stateCount += states;
+                }
+            }
+
+            // Rectángulos ordenados por nivel (alto + ancho en celdas): los dos lados de un corte
+            // tienen nivel estrictamente menor, así que cada nivel solo lee niveles ya resueltos.
+            const int levels = instance.nRows + instance.nCols;
+            std::vector<std::size_t> levelCount(levels + 2, 0);
+            forEachRect(rowBounds, colBounds, [&](const Rect &r)
+                        { ++levelCount[r.height() + r.width() + 1]; });
+            for (int l = 1; l < static_cast<int>(levelCount.size()); ++l)
+            {
+                levelCount[l] += levelCount[l - 1];
+            }
+            levelStart = levelCount;
+            rects.resize(static_cast<std::size_t>(rectCount));
+            forEachRect(rowBounds, colBounds, [&](const Rect &r)
+                        { rects[levelCount[r.height() + r.width()]++] = r; });
+
+            offsets.resize(rects.size() + 1, 0);
+            table = RectTable(rects.size());
+            for (std::size_t i = 0; i < rects.size(); ++i)
+            {
+                offsets[i + 1] = offsets[i] + zonesFor(rects[i]);
+                table.insert(packRect(rects[i]), static_cast<int>(i));
+            }
+            cells.resize(offsets.back());
+        }
+
+        void run(int threads)
+        {
+            const int levels = static_cast<int>(levelStart.size()) - 1;
+            if (threads <= 1)
+            {
+                long long count = 0;
+                for (std::size_t i = 0; i < rects.size(); ++i)
+                {
+                    count += solve(i);
+                }
+                transitions = count;
+                return;
+            }
+
+            WorkStealingPool pool(threads);
+            std::atomic<long long> count{0};
+            for (int l = 0; l < levels; ++l)
+            {
+                const std::size_t begin = levelStart[l];
+                const std::size_t end = levelStart[l + 1];
+                if (begin == end)
+                {
+                    continue;
+                }
+                // Bloques de varios rectángulos para amortizar el envío; varios por hilo para balancear.
+                const std::size_t block = std::max<std::size_t>(16, (end - begin) / (4 * static_cast<std::size_t>(threads)));
+                for (std::size_t first = begin; first < end; first += block)
+                {
+                    const std::size_t last = std::min(end, first + block);
+                    pool.submit([this, &count, first, last]()
+                                {
+                                    long long local = 0;
+                                    for (std::size_t i = first; i < last; ++i)
+                                    {
+                                        local += solve(i);
+                                    }
+                                    count += local; });
+                }
+                pool.wait();
+            }
+            transitions = count;
+        }
+
+        // Reconstruye la partición óptima de la grilla completa en p zonas.
+        std::vector<Rect> partition() const
+        {
+            std::vector<Rect> out;
+            out.reserve(p);
+            collect(Rect{0, instance.nRows - 1, 0, instance.nCols - 1}, p, out);
+            return out;
+        }
+
+        double bestEnergy() const
+        {
+            const int full = table.find(packRect(Rect{0, instance.nRows - 1, 0, instance.nCols - 1}));
+            return cells[offsets[full] + p - 1].energy;
+        }
+
+        long long rectCount() const { return static_cast<long long>(rects.size()); }
+        long long stateCount() const { return static_cast<long long>(cells.size()); }
+        long long transitionCount() const { return transitions; }
+
+    private:
+        std::vector<int> boundsOf(int n) const
+        {
+            std::vector<int> bounds;
+            for (int b = 0; b < n; b += stride)
+            {
+                bounds.push_back(b);
+            }
+            bounds.push_back(n);
+            return bounds;
+        }
+
+        template <typename F>
+        static void forEachRect(const std::vector<int> &rowBounds, const std::vector<int> &colBounds, F &&f)
+        {
+            for (std::size_t i1 = 0; i1 + 1 < rowBounds.size(); ++i1)
+            {
+                for (std::size_t j1 = i1 + 1; j1 < rowBounds.size(); ++j1)
+                {
+                    for (std::size_t i2 = 0; i2 + 1 < colBounds.size(); ++i2)
+                    {
+                        for (std::size_t j2 = i2 + 1; j2 < colBounds.size(); ++j2)
+                        {
+                            f(Rect{rowBounds[i1], rowBounds[j1] - 1, colBounds[i2], colBounds[j2] - 1});
+                        }
+                    }
+                }
+            }
+        }
+
+        // Zonas posibles en r: a lo sumo p y a lo sumo un bloque de la malla de cortes por zona.
+        int zonesFor(const Rect &r) const
+        {
+            const long long rowBlocks = (r.height() + stride - 1) / stride;
+            const long long colBlocks = (r.width() + stride - 1) / stride;
+            return static_cast<int>(std::min<long long>(p, rowBlocks * colBlocks));
+        }
+
+        // Mismo criterio que EnergyTracker: error de la zona más la penalización ponderada.
+        double zoneEnergy(const Rect &r) const
+        {
+            const double sse = integral.sse(r);
+            const double variance = sse / static_cast<double>(r.area());
+            return sse + penaltyWeight * (variance > maxVariance ? variance - maxVariance : 0.0);
+        }
+
+        // Resuelve E(r, k) para todo k del rectángulo i; devuelve las transiciones evaluadas.
+        long long solve(std::size_t i)
+        {
+            const Rect r = rects[i];
+            DPCell *out = &cells[offsets[i]];
+            const int zones = static_cast<int>(offsets[i + 1] - offsets[i]);
+            out[0] = DPCell{zoneEnergy(r), 0, 0, false};
+            for (int k = 1; k < zones; ++k)
+            {
+                out[k] = DPCell{std::numeric_limits<double>::infinity(), 0, 0, false};
+            }
+            if (zones == 1)
+            {
+                return 0;
+            }
+
+            long long count = 0;
+            // Los lados de r caen en límites de la malla, así que los cortes interiores son r.top + s, r.top + 2s, ...
+            for (int cut = r.top + stride; cut <= r.bottom; cut += stride)
+            {
+                count += combine(Rect{r.top, cut - 1, r.left, r.right}, Rect{cut, r.bottom, r.left, r.right}, cut, true, out, zones);
+            }
+            for (int cut = r.left + stride; cut <= r.right; cut += stride)
+            {
+                count += combine(Rect{r.top, r.bottom, r.left, cut - 1}, Rect{r.top, r.bottom, cut, r.right}, cut, false, out, zones);
+            }
+            return count;
+        }
+
+        long long combine(const Rect &first, const Rect &second, int cut, bool horizontal, DPCell *out, int zones) const
+        {
+            const int a = table.find(packRect(first));
+            const int b = table.find(packRect(second));
+            const DPCell *ca = &cells[offsets[a]];
+            const DPCell *cb = &cells[offsets[b]];
+            const int za = static_cast<int>(offsets[a + 1] - offsets[a]);
+            const int zb = static_cast<int>(offsets[b + 1] - offsets[b]);
+
+            long long count = 0;
+            for (int x = 1; x <= za && x < zones; ++x)
+            {
+                const double ex = ca[x - 1].energy;
+                const int maxY = std::min(zb, zones - x);
+                for (int y = 1; y <= maxY; ++y)
+                {
+                    const double e = ex + cb[y - 1].energy;
+                    DPCell &cell = out[x + y - 1];
+                    if (e < cell.energy)
+                    {
+                        cell = DPCell{e, cut, static_cast<short>(x), horizontal};
+                    }
+                }
+                count += maxY;
+            }
+            return count;
+        }
+
+        void collect(const Rect &r, int k, std::vector<Rect> &out) const
+        {
+            if (k == 1)
+            {
+                out.push_back(r);
+                return;
+            }
+            const DPCell &cell = cells[offsets[table.find(packRect(r))] + k - 1];
+            if (cell.horizontal)
+            {
+                collect(Rect{r.top, cell.cut - 1, r.left, r.right}, cell.kFirst, out);
+                collect(Rect{cell.cut, r.bottom, r.left, r.right}, k - cell.kFirst, out);
+            }
+            else
+            {
+                collect(Rect{r.top, r.bottom, r.left, cell.cut - 1}, cell.kFirst, out);
+                collect(Rect{r.top, r.bottom, cell.cut, r.right}, k - cell.kFirst, out);
+            }
+        }
+
+        const ProblemInstance &instance;
+        const IntegralImage integral;
+        const int stride;
+        const int p;
+        const double maxVariance;
+        const double penaltyWeight;
+
+        std::vector<Rect> rects;              // ordenados por nivel
+        std::vector<std::size_t> levelStart;  // rects[levelStart[l] .. levelStart[l + 1]) tienen alto + ancho = l
+        std::vector<std::size_t> offsets;     // celdas del rectángulo i: cells[offsets[i] .. offsets[i + 1])
+        std::vector<DPCell> cells;            // E(rects[i], k) en cells[offsets[i] + k - 1]
+        RectTable table;
+        long long transitions = 0;
+    };
+
+    int resolveThreads(const SAConfig &cfg)
+    {
+        int threads = cfg.threads;
+        if (threads <= 0)
+        {
+            threads = static_cast<int>(std::thread::hardware_concurrency());
+        }
+        return std::max(1, threads);
+    }
+}
+
+Solution guillotineDP(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *chainStats, Solution *initialOut, DPStats *dpStats)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+    if (cfg.dpCutStride < 1)
+    {
+        throw std::runtime_error("guillotineDP: dp_cut_stride debe ser >= 1");
+    }
+
+    GuillotineSolver solver(instance, cfg);
+    solver.run(resolveThreads(cfg));
+
+    Solution best;
+    best.rects = solver.partition();
+    std::vector<double> means(instance.p + 1), variances(instance.p + 1);
+    std::vector<int> counts(instance.p + 1);
+    const IntegralImage integral(instance);
+    best.errorTotal = calculateErrorAndVariance(instance, integral, best.rects, means, variances, counts);
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - startTime).count();
+    if (initialOut)
+    {
+        *initialOut = best;
+    }
+    if (chainStats)
+    {
+        SAStats st;
+        st.initialEnergy = solver.bestEnergy();
+        st.bestEnergy = solver.bestEnergy();
+        st.elapsedSeconds = elapsed;
+        chainStats->assign(1, st);
+    }
+    if (dpStats)
+    {
+        dpStats->rects = solver.rectCount();
+        dpStats->states = solver.stateCount();
+        dpStats->transitions = solver.transitionCount();
+        dpStats->cutStride = cfg.dpCutStride;
+        dpStats->energy = solver.bestEnergy();
+        dpStats->elapsedSeconds = elapsed;
+    }
+    return best;
+}
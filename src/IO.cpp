@@ -1,8 +1,16 @@
 #include "IO.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
+#include "MappedFile.hpp"
 #include "third_party/json.hpp"
 
 using nlohmann::json;
@@ -10,10 +18,54 @@ using std::cin;
 using std::cout;
 using std::endl;
 
+namespace
+{
+    // Cabecera del formato .sppb (64 bytes; el resto queda en cero).
+    constexpr char kSppbMagic[4] = {'S', 'P', 'P', 'B'};
+    constexpr std::uint32_t kSppbVersion = 1;
+    constexpr std::uint32_t kSppbHeaderBytes = 64;
+
+    struct SppbHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t rows;
+        std::uint32_t cols;
+        std::uint32_t dtype;
+        std::uint32_t headerBytes;
+    };
+    static_assert(sizeof(SppbHeader) <= kSppbHeaderBytes, "La cabecera .sppb debe caber en 64 bytes");
+
+    bool hasExtension(const std::string &path, const char *ext)
+    {
+        return std::filesystem::path(path).extension() == ext;
+    }
+}
+
 namespace IO
 {
+    std::string resolveInstancePath(const std::string &arg)
+    {
+        // Permitir pasar solo el nombre, el nombre con extension o una ruta completa.
+        if (arg.find_first_of("/\\") != std::string::npos)
+        {
+            return arg;
+        }
+        std::string name = arg;
+        if (name.find('.') == std::string::npos)
+        {
+            name += ".spp";
+        }
+        return "data/instances/" + name;
+    }
+
     ProblemInstance readInstanceFromFile(const std::string &path)
     {
+        if (hasExtension(path, ".sppb"))
+        {
+            return readBinaryInstanceFromFile(path);
+        }
+
         std::ifstream in(path);
         if (!in)
         {
@@ -33,7 +85,7 @@ namespace IO
             throw std::runtime_error("N y M deben ser positivos en el archivo: " + path);
         }
 
-        inst.S.assign(inst.nRows, std::vector<double>(inst.nCols, 0.0));
+        inst.S.assign(inst.nRows, inst.nCols, 0.0);
 
         for (int i = 0; i < inst.nRows; ++i)
         {
@@ -49,30 +101,150 @@ namespace IO
         return inst;
     }
 
+    ProblemInstance readBinaryInstanceFromFile(const std::string &path)
+    {
+        auto mapping = std::make_shared<MappedFile>(path);
+        const MappedFile &file = *mapping;
+
+        SppbHeader header;
+        if (file.size() < kSppbHeaderBytes)
+        {
+            throw std::runtime_error("Archivo .sppb truncado (sin cabecera): " + path);
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, kSppbMagic, sizeof(kSppbMagic)) != 0)
+        {
+            throw std::runtime_error("El archivo no tiene formato .sppb: " + path);
+        }
+        if (header.version != kSppbVersion || header.headerBytes != kSppbHeaderBytes)
+        {
+            throw std::runtime_error("Version de .sppb no soportada en: " + path);
+        }
+        if (header.rows == 0 || header.cols == 0 || header.rows > static_cast<std::uint32_t>(std::numeric_limits<int>::max()) || header.cols > static_cast<std::uint32_t>(std::numeric_limits<int>::max()))
+        {
+            throw std::runtime_error("N y M deben ser positivos en el archivo: " + path);
+        }
+
+        std::size_t valueBytes = 0;
+        if (header.dtype == static_cast<std::uint32_t>(SppbDtype::Float32))
+        {
+            valueBytes = sizeof(float);
+        }
+        else if (header.dtype == static_cast<std::uint32_t>(SppbDtype::Float64))
+        {
+            valueBytes = sizeof(double);
+        }
+        else
+        {
+            throw std::runtime_error("Tipo de dato desconocido en el archivo .sppb: " + path);
+        }
+
+        const std::size_t cells = static_cast<std::size_t>(header.rows) * header.cols;
+        if (file.size() != kSppbHeaderBytes + cells * valueBytes)
+        {
+            throw std::runtime_error("El tamano del archivo .sppb no coincide con N x M: " + path);
+        }
+
+        ProblemInstance inst;
+        inst.nRows = static_cast<int>(header.rows);
+        inst.nCols = static_cast<int>(header.cols);
+
+        // float64: S es una vista directa sobre el mapeo (sin copia); la cabecera de 64 bytes
+        // deja el primer valor alineado, ya que mmap devuelve direcciones alineadas a página.
+        const unsigned char *payload = file.data() + kSppbHeaderBytes;
+        if (valueBytes == sizeof(double))
+        {
+            inst.S = Grid<double>::view(inst.nRows, inst.nCols, reinterpret_cast<const double *>(payload), static_cast<std::size_t>(inst.nCols), mapping);
+            return inst;
+        }
+
+        // float32: se convierte a double en una sola pasada lineal.
+        inst.S.assign(inst.nRows, inst.nCols, 0.0);
+        const float *values = reinterpret_cast<const float *>(payload);
+        for (int i = 0; i < inst.nRows; ++i)
+        {
+            const float *src = values + static_cast<std::size_t>(i) * inst.nCols;
+            std::copy(src, src + inst.nCols, inst.S[i]);
+        }
+
+        return inst;
+    }
+
+    void writeBinaryInstanceToFile(const std::string &path, const ProblemInstance &instance, SppbDtype dtype)
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+        {
+            throw std::runtime_error("No se pudo abrir el archivo de salida: " + path);
+        }
+
+        unsigned char headerBytes[kSppbHeaderBytes] = {};
+        SppbHeader header;
+        std::memcpy(header.magic, kSppbMagic, sizeof(kSppbMagic));
+        header.version = kSppbVersion;
+        header.rows = static_cast<std::uint32_t>(instance.nRows);
+        header.cols = static_cast<std::uint32_t>(instance.nCols);
+        header.dtype = static_cast<std::uint32_t>(dtype);
+        header.headerBytes = kSppbHeaderBytes;
+        std::memcpy(headerBytes, &header, sizeof(header));
+        out.write(reinterpret_cast<const char *>(headerBytes), sizeof(headerBytes));
+
+        std::vector<float> buffer(dtype == SppbDtype::Float32 ? instance.nCols : 0);
+        for (int i = 0; i < instance.nRows; ++i)
+        {
+            const double *row = instance.S[i];
+            if (dtype == SppbDtype::Float64)
+            {
+                out.write(reinterpret_cast<const char *>(row), static_cast<std::streamsize>(instance.nCols * sizeof(double)));
+            }
+            else
+            {
+                std::copy(row, row + instance.nCols, buffer.begin());
+                out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(float)));
+            }
+        }
+
+        if (!out)
+        {
+            throw std::runtime_error("Error al escribir el archivo: " + path);
+        }
+    }
+
     void readParamsFromConsole(ProblemInstance &instance)
     {
 
         // p: cantidad de sensores/zonas
-        while (true)
+        while (instance.p <= 0)
         {
             cout << "Ingrese la cantidad de sensores/zonas (p > 0): ";
             if (cin >> instance.p && instance.p > 0)
             {
                 break;
             }
+            if (cin.eof())
+            {
+                throw std::runtime_error("Entrada agotada al leer p; indiquelo con --p o con la clave \"p\" del JSON.");
+            }
+            instance.p = 0;
             cout << "Valor invalido. p debe ser un entero positivo." << endl;
             cin.clear();
             cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
 
         // alpha: nivel de homogeneidad
-        while (true)
+        while (instance.alpha <= 0.0)
         {
             cout << "Ingrese el nivel de homogeneidad: ";
             if (cin >> instance.alpha && instance.alpha > 0.0 && instance.alpha <= 1.0) // ]0,1]
             {
                 break;
             }
+            if (cin.eof())
+            {
+                throw std::runtime_error("Entrada agotada al leer alpha; indiquelo con --alpha o con la clave \"alpha\" del JSON.");
+            }
+            instance.alpha = 0.0;
             cout << "Valor invalido. alpha debe estar en ]0,1] en formato decimal." << endl;
             cin.clear();
             cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -100,43 +272,260 @@ namespace IO
         cfg.coolingFactor = j.value("cooling_factor", 0.95);
         cfg.maxTimeSeconds = j.value("max_time_seconds", 5.0);
         cfg.penaltyWeight = j.value("penalty_weight", 1000.0);
+        cfg.traceInterval = j.value("trace_interval", 0);
+        cfg.schedule = j.value("schedule", std::string("geometric"));
+        cfg.autoT0 = j.value("auto_t0", false);
+        cfg.autoT0Acceptance = j.value("auto_t0_acceptance", 0.8);
+        cfg.autoT0Samples = j.value("auto_t0_samples", 200);
+        cfg.reheatStagnation = j.value("reheat_stagnation", 0.0);
+        cfg.reheatFactor = j.value("reheat_factor", 10.0);
+        cfg.seeding = j.value("seeding", std::string("random"));
+        cfg.seedBeamWidth = j.value("seed_beam_width", 8);
+        cfg.seedBeamCuts = j.value("seed_beam_cuts", 3);
+        cfg.chains = j.value("chains", 1);
+        cfg.threads = j.value("threads", 0);
+        cfg.totalTimeSeconds = j.value("total_time_seconds", 0.0);
+        cfg.seed = j.value("seed", 0ULL);
+        cfg.mode = j.value("mode", std::string("sa"));
+        cfg.pyramidLevels = j.value("pyramid_levels", 0);
+        cfg.pyramidMinSide = j.value("pyramid_min_side", 32);
+        cfg.pyramidFineShare = j.value("pyramid_fine_share", 0.4);
+        cfg.pyramidRefineT0 = j.value("pyramid_refine_t0", 0.05);
+        cfg.ptReplicas = j.value("pt_replicas", 8);
+        cfg.ptTMin = j.value("pt_t_min", 1.0);
+        cfg.ptTMax = j.value("pt_t_max", 1000.0);
+        cfg.ptSpacing = j.value("pt_spacing", std::string("geometric"));
+        cfg.ptSwapInterval = j.value("pt_swap_interval", 100);
+        cfg.islands = j.value("islands", 4);
+        cfg.islandMigrationInterval = j.value("island_migration_interval", 1000);
+        cfg.islandStagnation = j.value("island_stagnation", 20000);
+        cfg.islandCrossoverRate = j.value("island_crossover_rate", 0.5);
+        cfg.opBorderWeight = j.value("op_border_weight", 1.0);
+        cfg.opSlideWeight = j.value("op_slide_weight", 1.0);
+        cfg.opMergeSplitWeight = j.value("op_merge_split_weight", 0.5);
+        cfg.opRecutWeight = j.value("op_recut_weight", 1.0);
+        cfg.opSlideMaxCells = j.value("op_slide_max_cells", 3);
+        cfg.opAdaptive = j.value("op_adaptive", true);
+        cfg.opAdaptInterval = j.value("op_adapt_interval", 1000);
+        cfg.opMinProbability = j.value("op_min_probability", 0.05);
+        cfg.dpCutStride = j.value("dp_cut_stride", 1);
+        cfg.dpMaxStates = j.value("dp_max_states", 20000000LL);
+
+        if (cfg.mode != "sa" && cfg.mode != "pyramid" && cfg.mode != "tempering" && cfg.mode != "islands" && cfg.mode != "dp")
+        {
+            throw std::runtime_error("Modo desconocido en " + path + ": " + cfg.mode + " (use \"sa\", \"pyramid\", \"tempering\", \"islands\" o \"dp\")");
+        }
+        if (cfg.islands < 1 || cfg.islandMigrationInterval < 1 || cfg.islandStagnation < 0 || cfg.islandCrossoverRate < 0.0 || cfg.islandCrossoverRate > 1.0)
+        {
+            throw std::runtime_error("Se requiere islands >= 1, island_migration_interval >= 1, island_stagnation >= 0 y island_crossover_rate en [0, 1] en " + path);
+        }
+        if (cfg.pyramidLevels < 0 || cfg.pyramidMinSide < 1 || cfg.pyramidFineShare <= 0.0 || cfg.pyramidFineShare > 1.0 || cfg.pyramidRefineT0 <= 0.0)
+        {
+            throw std::runtime_error("Se requiere pyramid_levels >= 0, pyramid_min_side >= 1, 0 < pyramid_fine_share <= 1 y pyramid_refine_t0 > 0 en " + path);
+        }
+        if (cfg.schedule != "geometric" && cfg.schedule != "geometric_time" && cfg.schedule != "lam")
+        {
+            throw std::runtime_error("schedule desconocido en " + path + ": " + cfg.schedule + " (use \"geometric\", \"geometric_time\" o \"lam\")");
+        }
+        if (cfg.schedule != "geometric" && cfg.maxTimeSeconds <= 0.0 && cfg.totalTimeSeconds <= 0.0)
+        {
+            throw std::runtime_error("schedule \"" + cfg.schedule + "\" requiere un presupuesto de tiempo (max_time_seconds o total_time_seconds) en " + path);
+        }
+        if (cfg.seeding != "random" && cfg.seeding != "variance" && cfg.seeding != "beam" && cfg.seeding != "kmeans" && cfg.seeding != "dp")
+        {
+            throw std::runtime_error("seeding desconocido en " + path + ": " + cfg.seeding + " (use \"random\", \"variance\", \"beam\", \"kmeans\" o \"dp\")");
+        }
+        if (cfg.seedBeamWidth < 1 || cfg.seedBeamCuts < 1)
+        {
+            throw std::runtime_error("seed_beam_width y seed_beam_cuts deben ser >= 1 en " + path);
+        }
+        if (cfg.autoT0Acceptance <= 0.0 || cfg.autoT0Acceptance >= 1.0)
+        {
+            throw std::runtime_error("auto_t0_acceptance debe estar en (0, 1) en " + path);
+        }
+        if (cfg.ptSpacing != "geometric" && cfg.ptSpacing != "linear")
+        {
+            throw std::runtime_error("pt_spacing desconocido en " + path + ": " + cfg.ptSpacing + " (use \"geometric\" o \"linear\")");
+        }
+        if (cfg.ptTMin <= 0.0 || cfg.ptTMax < cfg.ptTMin)
+        {
+            throw std::runtime_error("Se requiere 0 < pt_t_min <= pt_t_max en " + path);
+        }
+        if (cfg.traceInterval < 0)
+        {
+            throw std::runtime_error("trace_interval debe ser >= 0 en " + path);
+        }
+        if (cfg.dpCutStride < 1 || cfg.dpMaxStates < 1)
+        {
+            throw std::runtime_error("dp_cut_stride y dp_max_states deben ser >= 1 en " + path);
+        }
+        if (cfg.opBorderWeight < 0.0 || cfg.opSlideWeight < 0.0 || cfg.opMergeSplitWeight < 0.0 || cfg.opRecutWeight < 0.0)
+        {
+            throw std::runtime_error("Los pesos op_*_weight deben ser >= 0 en " + path);
+        }
+        if (cfg.opBorderWeight + cfg.opSlideWeight + cfg.opMergeSplitWeight + cfg.opRecutWeight <= 0.0)
+        {
+            throw std::runtime_error("Al menos un peso op_*_weight debe ser > 0 en " + path);
+        }
 
         return cfg;
     }
 
-    void writeSolutionToFile(const std::string &path, double errorTotal, const ProblemInstance &instance, const std::vector<std::vector<int>> &Z)
+    void readRunOptionsFromJson(const std::string &path, RunOptions &opts)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            throw std::runtime_error("No se pudo abrir el archivo de config: " + path);
+        }
+
+        json j;
+        in >> j;
+
+        // Solo completan lo que no se indicó por línea de comandos.
+        if (opts.p <= 0)
+        {
+            opts.p = j.value("p", 0);
+        }
+        if (opts.alpha <= 0.0)
+        {
+            opts.alpha = j.value("alpha", 0.0);
+        }
+        if (opts.outputDir.empty())
+        {
+            opts.outputDir = j.value("output_dir", std::string("data/solutions"));
+        }
+
+        if (opts.p < 0)
+        {
+            throw std::runtime_error("p debe ser un entero positivo en " + path);
+        }
+        if (opts.alpha < 0.0 || opts.alpha > 1.0)
+        {
+            throw std::runtime_error("alpha debe estar en ]0,1] en " + path);
+        }
+    }
+
+    void writeSolutionToFile(const std::string &path, double errorTotal, const ProblemInstance &instance, const Grid<int> &Z, unsigned long long seed)
     {
-        if (static_cast<int>(Z.size()) != instance.nRows)
+        if (Z.rows() != instance.nRows)
         {
             throw std::runtime_error("La matriz Z no coincide con la cantidad de filas del problema.");
         }
-        for (const auto &row : Z)
+        if (Z.cols() != instance.nCols)
+        {
+            throw std::runtime_error("La matriz Z no coincide con la cantidad de columnas del problema.");
+        }
+
+        // Se arma el archivo completo en memoria y se escribe de una vez: con grillas grandes
+        // es mucho más rápido que formatear etiqueta por etiqueta sobre el ofstream.
+        std::ostringstream header;
+        header << errorTotal << '\n';
+        std::string text = header.str();
+        text.reserve(text.size() + static_cast<size_t>(instance.nRows) * instance.nCols * 4 + 32);
+
+        char digits[16];
+        for (int i = 0; i < instance.nRows; ++i)
         {
-            if (static_cast<int>(row.size()) != instance.nCols)
+            const int *row = Z[i];
+            for (int j = 0; j < instance.nCols; ++j)
             {
-                throw std::runtime_error("La matriz Z no coincide con la cantidad de columnas del problema.");
+                const auto res = std::to_chars(digits, digits + sizeof(digits), row[j]);
+                text.append(digits, res.ptr);
+                text.push_back(j + 1 < instance.nCols ? ' ' : '\n');
             }
         }
 
-        std::ofstream out(path);
+        if (seed != 0)
+        {
+            text += "# seed=" + std::to_string(seed) + '\n';
+        }
+
+        std::ofstream out(path, std::ios::binary);
         if (!out)
         {
             throw std::runtime_error("No se pudo abrir el archivo de salida: " + path);
         }
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!out)
+        {
+            throw std::runtime_error("No se pudo escribir el archivo de salida: " + path);
+        }
+    }
 
-        out << errorTotal << '\n';
+    void writeStatsToJson(const std::string &path, const std::vector<SAStats> &chainStats, const SAConfig &cfg)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            throw std::runtime_error("No se pudo abrir el archivo de estadisticas: " + path);
+        }
 
-        for (int i = 0; i < instance.nRows; ++i)
+        json doc;
+        doc["seed"] = cfg.seed;
+        doc["mode"] = cfg.mode;
+        doc["schedule"] = cfg.schedule;
+        doc["seeding"] = cfg.seeding;
+        doc["phase_timers"] = telemetryPhasesEnabled();
+        doc["chains"] = json::array();
+        for (const SAStats &st : chainStats)
         {
-            for (int j = 0; j < instance.nCols; ++j)
+            const SATelemetry &t = st.telemetry;
+            json chain;
+            chain["iterations"] = st.iterations;
+            chain["initial_temperature"] = st.initialTemperature;
+            chain["initial_energy"] = st.initialEnergy;
+            chain["best_energy"] = st.bestEnergy;
+            chain["reheats"] = st.reheats;
+            chain["elapsed_seconds"] = st.elapsedSeconds;
+            chain["counters"] = {{"proposals", t.proposals},
+                                 {"proposal_failures", t.proposalFailures},
+                                 {"metropolis_accepts", t.metropolisAccepts},
+                                 {"metropolis_rejects", t.metropolisRejects},
+                                 {"improvements", t.improvements}};
+            chain["start"] = {{"initial_valid", t.start.initialValid},
+                              {"attempts", t.start.attempts},
+                              {"neighbor_failures", t.start.neighborFailures},
+                              {"invalid_rejects", t.start.invalidRejects}};
+            chain["seconds"] = {{"setup", t.setupSeconds}, {"start", t.startSeconds}, {"t0", t.t0Seconds}, {"loop", t.loopSeconds}};
+            if (telemetryPhasesEnabled())
+            {
+                chain["seconds"]["propose"] = t.phases.proposeSeconds;
+                chain["seconds"]["evaluate"] = t.phases.evaluateSeconds;
+                chain["seconds"]["commit"] = t.phases.commitSeconds;
+            }
+            chain["operators"] = json::array();
+            for (const OperatorTelemetry &op : t.operators)
+            {
+                chain["operators"].push_back({{"name", op.name}, {"attempts", op.attempts}, {"accepted", op.accepted}, {"probability", op.probability}});
+            }
+            if (cfg.mode == "islands")
+            {
+                chain["migration"] = {{"publishes", t.migration.publishes},
+                                      {"adoptions", t.migration.adoptions},
+                                      {"crossovers", t.migration.crossovers},
+                                      {"busy", t.migration.busy}};
+            }
+            if (!t.levels.empty())
+            {
+                chain["levels"] = json::array();
+                for (const LevelTelemetry &level : t.levels)
+                {
+                    chain["levels"].push_back({{"rows", level.rows}, {"cols", level.cols}, {"factor", level.factor}, {"iterations", level.iterations},
+                                               {"initial_energy", level.initialEnergy}, {"best_energy", level.bestEnergy}, {"seconds", level.seconds}});
+                }
+            }
+            if (!t.trace.empty())
             {
-                out << Z[i][j];
-                if (j + 1 < instance.nCols)
+                // Columnas: segundos, iteración, temperatura, energía actual, mejor energía.
+                chain["trace"] = json::array();
+                for (const TraceSample &sample : t.trace)
                 {
-                    out << ' ';
+                    chain["trace"].push_back({sample.seconds, sample.iteration, sample.temperature, sample.energy, sample.bestEnergy});
                 }
             }
-            out << '\n';
+            doc["chains"].push_back(std::move(chain));
         }
+        out << doc.dump(2) << '\n';
     }
 }
@@ -0,0 +1,60 @@
+#include "IntegralImage.hpp"
+
+#include <algorithm>
+
+IntegralImage::IntegralImage(const ProblemInstance &instance)
+    : stride(instance.nCols + 1),
+      sums(static_cast<size_t>(instance.nRows + 1) * (instance.nCols + 1), 0.0),
+      sumsSq(static_cast<size_t>(instance.nRows + 1) * (instance.nCols + 1), 0.0)
+{
+    // sums[(i+1)*stride + (j+1)] = suma de S[0..i][0..j]
+    for (int i = 0; i < instance.nRows; ++i)
+    {
+        double rowSum = 0.0;
+        double rowSumSq = 0.0;
+        const size_t above = static_cast<size_t>(i) * stride;
+        const size_t here = above + stride;
+        for (int j = 0; j < instance.nCols; ++j)
+        {
+            const double v = instance.S[i][j];
+            rowSum += v;
+            rowSumSq += v * v;
+            sums[here + j + 1] = sums[above + j + 1] + rowSum;
+            sumsSq[here + j + 1] = sumsSq[above + j + 1] + rowSumSq;
+        }
+    }
+}
+
+double IntegralImage::lookup(const std::vector<double> &table, const Rect &r) const
+{
+    const size_t top = static_cast<size_t>(r.top) * stride;
+    const size_t bottom = static_cast<size_t>(r.bottom + 1) * stride;
+    return table[bottom + r.right + 1] - table[top + r.right + 1] - table[bottom + r.left] + table[top + r.left];
+}
+
+double IntegralImage::sum(const Rect &r) const
+{
+    return lookup(sums, r);
+}
+
+double IntegralImage::sumSq(const Rect &r) const
+{
+    return lookup(sumsSq, r);
+}
+
+double IntegralImage::mean(const Rect &r) const
+{
+    return sum(r) / static_cast<double>(count(r));
+}
+
+double IntegralImage::sse(const Rect &r) const
+{
+    const double s = sum(r);
+    // Puede quedar levemente negativo por cancelación numérica.
+    return std::max(0.0, sumSq(r) - s * s / static_cast<double>(count(r)));
+}
+
+double IntegralImage::variance(const Rect &r) const
+{
+    return sse(r) / static_cast<double>(count(r));
+}
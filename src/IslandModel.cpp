@@ -0,0 +1,346 @@
+#include "IslandModel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "AnnealingChain.hpp"
+#include "Schedule.hpp"
+#include "Seeding.hpp"
+
+namespace
+{
+    // Ranura con la mejor partición publicada (seqlock). Un escritor toma la ranura llevando
+    // la secuencia de par a impar con un CAS y, si otro hilo la tiene, desiste; un lector
+    // copia los datos y descarta la copia si la secuencia cambió mientras leía. Los datos
+    // son atómicos relajados, de modo que leer durante una escritura no es una carrera de
+    // datos: a lo sumo da una copia inconsistente, que se detecta y se descarta.
+    class SharedBest
+    {
+    public:
+        explicit SharedBest(int p) : coords(4 * static_cast<std::size_t>(p)) {}
+
+        // Energía publicada (infinito si todavía no hay). Sirve para decidir sin copiar.
+        double energy() const { return bestEnergy.load(std::memory_order_acquire); }
+
+        // Cambia con cada publicación; 0 = nada publicado.
+        unsigned long long version() const { return sequence.load(std::memory_order_acquire); }
+
+        // Publica 'rects' si mejora a la global. Devuelve false si no mejora o si otro hilo escribía.
+        bool tryPublish(const std::vector<Rect> &rects, double e)
+        {
+            unsigned long long seq = sequence.load(std::memory_order_relaxed);
+            if ((seq & 1) != 0 || e >= bestEnergy.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            if (!sequence.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return false;
+            }
+            if (e >= bestEnergy.load(std::memory_order_relaxed)) // otro hilo publicó algo mejor entretanto
+            {
+                sequence.store(seq, std::memory_order_release);
+                return false;
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            for (std::size_t k = 0; k < rects.size(); ++k)
+            {
+                coords[4 * k].store(rects[k].top, std::memory_order_relaxed);
+                coords[4 * k + 1].store(rects[k].bottom, std::memory_order_relaxed);
+                coords[4 * k + 2].store(rects[k].left, std::memory_order_relaxed);
+                coords[4 * k + 3].store(rects[k].right, std::memory_order_relaxed);
+            }
+            count.store(static_cast<int>(rects.size()), std::memory_order_relaxed);
+            bestEnergy.store(e, std::memory_order_relaxed);
+            sequence.store(seq + 2, std::memory_order_release);
+            return true;
+        }
+
+        // Copia la partición publicada. Devuelve false si no hay o si se escribía mientras se leía.
+        bool tryRead(std::vector<Rect> &rects, double &e, unsigned long long &ver) const
+        {
+            const unsigned long long before = sequence.load(std::memory_order_acquire);
+            if (before == 0 || (before & 1) != 0)
+            {
+                return false;
+            }
+            const int n = std::min(count.load(std::memory_order_relaxed), static_cast<int>(coords.size() / 4));
+            rects.resize(n);
+            for (int k = 0; k < n; ++k)
+            {
+                rects[k] = Rect{coords[4 * k].load(std::memory_order_relaxed), coords[4 * k + 1].load(std::memory_order_relaxed),
+                                coords[4 * k + 2].load(std::memory_order_relaxed), coords[4 * k + 3].load(std::memory_order_relaxed)};
+            }
+            const double published = bestEnergy.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != before)
+            {
+                return false;
+            }
+            e = published;
+            ver = before;
+            return true;
+        }
+
+    private:
+        std::atomic<unsigned long long> sequence{0}; // impar = escritura en curso
+        std::atomic<double> bestEnergy{std::numeric_limits<double>::infinity()};
+        std::atomic<int> count{0};
+        std::vector<std::atomic<int>> coords; // top, bottom, left, right de cada zona
+    };
+
+    // Zonas de 'rects' antes de la fila (o columna) 'at', o -1 si alguna zona cruza esa línea.
+    int zonesBefore(const std::vector<Rect> &rects, bool horizontal, int at)
+    {
+        int before = 0;
+        for (const Rect &r : rects)
+        {
+            const int lo = horizontal ? r.top : r.left;
+            const int hi = horizontal ? r.bottom : r.right;
+            if (hi < at)
+            {
+                ++before;
+            }
+            else if (lo < at)
+            {
+                return -1;
+            }
+        }
+        return before;
+    }
+
+    // Cruce por una línea guillotina común: si una fila (o columna) es un corte de ambas
+    // particiones con la misma cantidad de zonas de cada lado, el hijo toma un lado de cada
+    // padre y sigue siendo un mosaico de p rectángulos. Devuelve false si no hay tal línea.
+    bool crossover(const ProblemInstance &instance, const std::vector<Rect> &a, const std::vector<Rect> &b, Rng &rng, std::vector<Rect> &child)
+    {
+        struct Line
+        {
+            bool horizontal;
+            int at;
+        };
+        std::vector<Line> lines;
+        for (int at = 1; at < instance.nRows; ++at)
+        {
+            const int before = zonesBefore(a, true, at);
+            if (before >= 0 && before == zonesBefore(b, true, at))
+            {
+                lines.push_back(Line{true, at});
+            }
+        }
+        for (int at = 1; at < instance.nCols; ++at)
+        {
+            const int before = zonesBefore(a, false, at);
+            if (before >= 0 && before == zonesBefore(b, false, at))
+            {
+                lines.push_back(Line{false, at});
+            }
+        }
+        if (lines.empty())
+        {
+            return false;
+        }
+
+        const Line line = lines[std::uniform_int_distribution<std::size_t>(0, lines.size() - 1)(rng)];
+        const bool firstFromA = std::uniform_int_distribution<int>(0, 1)(rng) == 0;
+        const std::vector<Rect> &first = firstFromA ? a : b;
+        const std::vector<Rect> &second = firstFromA ? b : a;
+        child.clear();
+        for (const Rect &r : first)
+        {
+            if ((line.horizontal ? r.bottom : r.right) < line.at)
+            {
+                child.push_back(r);
+            }
+        }
+        for (const Rect &r : second)
+        {
+            if ((line.horizontal ? r.top : r.left) >= line.at)
+            {
+                child.push_back(r);
+            }
+        }
+        return true;
+    }
+}
+
+Solution islandAnnealing(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *islandStats, Solution *initialOut)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+    auto secondsSince = [](Clock::time_point t)
+    { return std::chrono::duration<double>(Clock::now() - t).count(); };
+
+    const int islands = std::max(1, cfg.islands);
+    const long long interval = std::max(1, cfg.islandMigrationInterval);
+    SAConfig islandCfg = cfg;
+    islandCfg.maxTimeSeconds = cfg.totalTimeSeconds > 0.0 ? cfg.totalTimeSeconds : cfg.maxTimeSeconds;
+
+    const double totalVariance = calculateTotalVariance(instance);
+    const IntegralImage integral(instance);
+    const double setupSeconds = secondsSince(startTime);
+
+    std::vector<Rng> rngs;
+    std::vector<Solution> initials(islands);
+    std::vector<SAStats> stats(islands);
+    std::vector<std::unique_ptr<AnnealingChain>> chains;
+    const auto startPhase = Clock::now();
+    const bool sharedSeed = isSharedSeeding(cfg);
+    const Solution seed = sharedSeed ? buildSharedSeed(instance, integral, totalVariance, cfg) : Solution();
+    for (int i = 0; i < islands; ++i)
+    {
+        rngs.push_back(makeChainRng(cfg, static_cast<unsigned>(i)));
+        initials[i] = buildStartingSolution(instance, integral, totalVariance, cfg, rngs[i], &stats[i].telemetry.start, sharedSeed ? &seed : nullptr);
+        chains.push_back(std::make_unique<AnnealingChain>(instance, integral, totalVariance, cfg));
+        chains[i]->reset(initials[i]);
+        stats[i].initialEnergy = chains[i]->energy();
+    }
+    const double startSeconds = secondsSince(startPhase);
+
+    SharedBest shared(instance.p);
+    std::atomic<bool> stop{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&](int i) {
+        try
+        {
+            AnnealingChain &chain = *chains[i];
+            Rng &rng = rngs[i];
+            SAStats &st = stats[i];
+            MigrationTelemetry &migration = st.telemetry.migration;
+            std::uniform_real_distribution<double> uniform01(0.0, 1.0);
+
+            const auto t0Phase = Clock::now();
+            const double T0 = cfg.autoT0 ? estimateInitialTemperature(chain, islandCfg, rng) : cfg.T0;
+            st.telemetry.t0Seconds = secondsSince(t0Phase);
+            CoolingSchedule schedule(islandCfg, T0, startTime);
+
+            const auto loopPhase = Clock::now();
+            long long lastImprovement = 0;
+            unsigned long long seenVersion = 0;
+            Solution incoming;
+            Solution child;
+            incoming.rects.reserve(instance.p);
+            child.rects.reserve(instance.p);
+            while (!schedule.finished())
+            {
+                const long long improvementsBefore = chain.improvements();
+                const bool accepted = chain.step(schedule.temperature(), rng);
+                const bool improved = chain.improvements() != improvementsBefore;
+                schedule.observe(accepted, improved);
+                if (improved)
+                {
+                    lastImprovement = chain.iterations();
+                }
+                if (chain.iterations() % interval != 0)
+                {
+                    continue;
+                }
+                if (stop.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+
+                // Emigración: la mejor propia, si supera a la global.
+                if (chain.bestEnergy() < shared.energy())
+                {
+                    if (shared.tryPublish(chain.best().rects, chain.bestEnergy()))
+                    {
+                        ++migration.publishes;
+                    }
+                    else
+                    {
+                        ++migration.busy;
+                    }
+                }
+
+                // Inmigración: solo islas estancadas y solo una versión nueva mejor que la propia mejor.
+                if (chain.iterations() - lastImprovement < cfg.islandStagnation || shared.version() == seenVersion ||
+                    shared.energy() >= chain.bestEnergy())
+                {
+                    continue;
+                }
+                double energy = 0.0;
+                if (!shared.tryRead(incoming.rects, energy, seenVersion))
+                {
+                    ++migration.busy;
+                    continue;
+                }
+                lastImprovement = chain.iterations();
+                if (uniform01(rng) < cfg.islandCrossoverRate && crossover(instance, chain.current().rects, incoming.rects, rng, child.rects))
+                {
+                    chain.restart(child);
+                    ++migration.crossovers;
+                }
+                else
+                {
+                    chain.restart(incoming);
+                    ++migration.adoptions;
+                }
+            }
+
+            st.iterations = chain.iterations();
+            st.accepted = chain.accepted();
+            st.improvements = chain.improvements();
+            st.initialTemperature = T0;
+            st.reheats = schedule.reheats();
+            st.bestEnergy = chain.bestEnergy();
+            st.elapsedSeconds = secondsSince(startTime);
+            chain.fillTelemetry(st.telemetry);
+            st.telemetry.setupSeconds = setupSeconds;
+            st.telemetry.startSeconds = startSeconds;
+            st.telemetry.loopSeconds = secondsSince(loopPhase);
+        }
+        catch (...)
+        {
+            stop = true;
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(islands);
+    for (int i = 0; i < islands; ++i)
+    {
+        pool.emplace_back(worker, i);
+    }
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    int winner = 0;
+    for (int i = 1; i < islands; ++i)
+    {
+        if (chains[i]->bestEnergy() < chains[winner]->bestEnergy())
+        {
+            winner = i;
+        }
+    }
+
+    if (islandStats)
+    {
+        *islandStats = std::move(stats);
+    }
+    if (initialOut)
+    {
+        *initialOut = std::move(initials[winner]);
+    }
+    return chains[winner]->best();
+}
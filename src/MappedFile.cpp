@@ -0,0 +1,47 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("No se pudo abrir el archivo: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("No se pudo obtener el tamano del archivo: " + path);
+    }
+    length = static_cast<std::size_t>(st.st_size);
+
+    if (length > 0)
+    {
+        void *addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("No se pudo proyectar en memoria el archivo: " + path);
+        }
+        ::madvise(addr, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const unsigned char *>(addr);
+    }
+    // El mapeo sigue siendo válido tras cerrar el descriptor.
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (bytes)
+    {
+        ::munmap(const_cast<unsigned char *>(bytes), length);
+    }
+}
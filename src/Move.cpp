@@ -0,0 +1,18 @@
+#include "Move.hpp"
+
+void applyMove(std::vector<Rect> &rects, const Move &move)
+{
+    for (const RectChange &c : move.changes)
+    {
+        rects[c.zone - 1] = c.after;
+    }
+}
+
+void undoMove(std::vector<Rect> &rects, const Move &move)
+{
+    // En orden inverso, por si una zona aparece más de una vez.
+    for (auto it = move.changes.rbegin(); it != move.changes.rend(); ++it)
+    {
+        rects[it->zone - 1] = it->before;
+    }
+}
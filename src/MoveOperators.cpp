@@ -0,0 +1,479 @@
+#include "MoveOperators.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Desplaza el lado 'side' (0: superior, 1: inferior, 2: izquierdo, 3: derecho) del rectángulo.
+    void shiftSide(Rect &r, int side, int delta)
+    {
+        switch (side)
+        {
+        case 0:
+            r.top += delta;
+            break;
+        case 1:
+            r.bottom += delta;
+            break;
+        case 2:
+            r.left += delta;
+            break;
+        default:
+            r.right += delta;
+            break;
+        }
+    }
+
+    // Sentido (en filas o columnas) en que avanza el lado 'side' al crecer.
+    int outward(int side)
+    {
+        return side == 0 || side == 2 ? -1 : 1;
+    }
+
+    // Extensión del rectángulo perpendicular al lado (columnas para superior/inferior, filas para laterales).
+    int spanFrom(const Rect &r, int side) { return side <= 1 ? r.left : r.top; }
+    int spanTo(const Rect &r, int side) { return side <= 1 ? r.right : r.bottom; }
+    int thickness(const Rect &r, int side) { return side <= 1 ? r.height() : r.width(); }
+
+    Rect unionOf(const Rect &a, const Rect &b)
+    {
+        return Rect{std::min(a.top, b.top), std::max(a.bottom, b.bottom), std::min(a.left, b.left), std::max(a.right, b.right)};
+    }
+
+    // Elige un par de zonas que comparten el lado completo (su unión es un rectángulo).
+    bool pickFullSidePair(const ZoneAdjacency &adjacency, Rng &rng, int &a, int &b)
+    {
+        const auto &moves = adjacency.feasibleMoves();
+        if (moves.empty())
+        {
+            return false;
+        }
+        const auto &m = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+        a = m.receiver;
+        b = m.giver;
+        return true;
+    }
+
+    class BorderShiftOperator : public MoveOperator
+    {
+    public:
+        const char *name() const override { return "border"; }
+
+        bool propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move) override
+        {
+            return adjacency.proposeBorderMove(rects, rng, move);
+        }
+    };
+
+    class GuillotineSlideOperator : public MoveOperator
+    {
+    public:
+        explicit GuillotineSlideOperator(int maxCells) : maxCells(std::max(1, maxCells)) {}
+
+        const char *name() const override { return "slide"; }
+
+        bool propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move) override
+        {
+            const int p = static_cast<int>(rects.size());
+            if (p < 2)
+            {
+                return false;
+            }
+            if (static_cast<int>(marked.size()) < p + 1)
+            {
+                marked.assign(p + 1, 0);
+                near.reserve(p); // cada zona entra a lo sumo una vez: sin reservas en el bucle
+                far.reserve(p);
+            }
+
+            std::uniform_int_distribution<int> zoneDist(1, p);
+            std::uniform_int_distribution<int> sideDist(0, 3);
+            for (int attempt = 0; attempt < 4; ++attempt)
+            {
+                if (trySlide(rects, adjacency, zoneDist(rng), sideDist(rng), rng, move))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        bool trySlide(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, int zone, int side, Rng &rng, Move &move)
+        {
+            // Segmento de corte: zonas 'near' con el lado 'side' sobre la línea y zonas 'far'
+            // con el lado opuesto sobre ella, cerradas por adyacencia a través de la línea.
+            near.clear();
+            far.clear();
+            near.push_back(zone);
+            marked[zone] = 1;
+            size_t ni = 0, fi = 0;
+            while (ni < near.size() || fi < far.size())
+            {
+                for (; ni < near.size(); ++ni)
+                {
+                    for (const auto &n : adjacency.neighbors(near[ni], side))
+                    {
+                        if (!marked[n.zone])
+                        {
+                            marked[n.zone] = 1;
+                            far.push_back(n.zone);
+                        }
+                    }
+                }
+                for (; fi < far.size(); ++fi)
+                {
+                    for (const auto &n : adjacency.neighbors(far[fi], side ^ 1))
+                    {
+                        if (!marked[n.zone])
+                        {
+                            marked[n.zone] = 1;
+                            near.push_back(n.zone);
+                        }
+                    }
+                }
+            }
+            for (int z : near)
+            {
+                marked[z] = 0;
+            }
+            for (int z : far)
+            {
+                marked[z] = 0;
+            }
+            if (far.empty())
+            {
+                return false; // lado sobre el borde de la grilla
+            }
+
+            // Es un corte solo si ambos lados cubren exactamente el mismo tramo (sin zonas que lo crucen).
+            int lo = 0, hi = 0, nearMin = 0, farMin = 0;
+            if (!coverSpan(rects, near, side, lo, hi, nearMin) || !coverSpan(rects, far, side, lo, hi, farMin, true))
+            {
+                return false;
+            }
+
+            // d > 0: la línea avanza sobre 'far'; d < 0: retrocede sobre 'near'.
+            const int forward = std::min(maxCells, farMin - 1);
+            const int backward = std::min(maxCells, nearMin - 1);
+            if (forward + backward <= 0)
+            {
+                return false;
+            }
+            const int pick = std::uniform_int_distribution<int>(0, forward + backward - 1)(rng);
+            const int d = pick < forward ? pick + 1 : -(pick - forward + 1);
+            const int delta = outward(side) * d;
+
+            move.clear();
+            for (int z : near)
+            {
+                Rect after = rects[z - 1];
+                shiftSide(after, side, delta);
+                move.changes.push_back(RectChange{z, rects[z - 1], after});
+            }
+            for (int z : far)
+            {
+                Rect after = rects[z - 1];
+                shiftSide(after, side ^ 1, delta);
+                move.changes.push_back(RectChange{z, rects[z - 1], after});
+            }
+            return true;
+        }
+
+        // Tramo [lo, hi] cubierto por 'zones' y su espesor mínimo. Si 'mustMatch', el tramo
+        // debe coincidir con el ya calculado. Falla si las zonas no lo cubren sin huecos.
+        static bool coverSpan(const std::vector<Rect> &rects, const std::vector<int> &zones, int side, int &lo, int &hi, int &minThickness, bool mustMatch = false)
+        {
+            int from = spanFrom(rects[zones[0] - 1], side);
+            int to = spanTo(rects[zones[0] - 1], side);
+            long long covered = 0;
+            minThickness = thickness(rects[zones[0] - 1], side);
+            for (int z : zones)
+            {
+                const Rect &r = rects[z - 1];
+                from = std::min(from, spanFrom(r, side));
+                to = std::max(to, spanTo(r, side));
+                covered += spanTo(r, side) - spanFrom(r, side) + 1;
+                minThickness = std::min(minThickness, thickness(r, side));
+            }
+            if (covered != to - from + 1)
+            {
+                return false;
+            }
+            if (mustMatch)
+            {
+                return from == lo && to == hi;
+            }
+            lo = from;
+            hi = to;
+            return true;
+        }
+
+        int maxCells;
+        std::vector<int> near;
+        std::vector<int> far;
+        std::vector<unsigned char> marked;
+    };
+
+    class MergeSplitOperator : public MoveOperator
+    {
+    public:
+        const char *name() const override { return "merge_split"; }
+
+        bool propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move) override
+        {
+            const int p = static_cast<int>(rects.size());
+            int a = 0, b = 0;
+            if (p < 3 || !pickFullSidePair(adjacency, rng, a, b))
+            {
+                return false;
+            }
+
+            // Zona a partir: distinta del par y con al menos dos celdas.
+            std::uniform_int_distribution<int> zoneDist(1, p);
+            int c = 0;
+            for (int attempt = 0; attempt < 8 && c == 0; ++attempt)
+            {
+                const int z = zoneDist(rng);
+                if (z != a && z != b && rects[z - 1].area() >= 2)
+                {
+                    c = z;
+                }
+            }
+            if (c == 0)
+            {
+                return false;
+            }
+
+            const Rect &rc = rects[c - 1];
+            bool horizontal = rc.height() >= 2;
+            if (horizontal && rc.width() >= 2)
+            {
+                horizontal = std::uniform_int_distribution<int>(0, 1)(rng) == 0;
+            }
+            Rect first = rc;
+            Rect second = rc;
+            if (horizontal)
+            {
+                const int cut = std::uniform_int_distribution<int>(rc.top, rc.bottom - 1)(rng);
+                first.bottom = cut;
+                second.top = cut + 1;
+            }
+            else
+            {
+                const int cut = std::uniform_int_distribution<int>(rc.left, rc.right - 1)(rng);
+                first.right = cut;
+                second.left = cut + 1;
+            }
+
+            move.clear();
+            move.changes.push_back(RectChange{a, rects[a - 1], unionOf(rects[a - 1], rects[b - 1])});
+            move.changes.push_back(RectChange{b, rects[b - 1], second});
+            move.changes.push_back(RectChange{c, rc, first});
+            return true;
+        }
+    };
+
+    class RecutOperator : public MoveOperator
+    {
+    public:
+        const char *name() const override { return "recut"; }
+
+        bool propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move) override
+        {
+            int a = 0, b = 0;
+            if (!pickFullSidePair(adjacency, rng, a, b))
+            {
+                return false;
+            }
+            const Rect &ra = rects[a - 1];
+            const Rect &rb = rects[b - 1];
+            const Rect u = unionOf(ra, rb);
+            const bool stacked = ra.left == rb.left && ra.right == rb.right; // corte actual horizontal
+
+            // Posiciones de corte posibles (después de la fila/columna 'cut'), sin repetir el actual.
+            const int currentCut = stacked ? std::min(ra.bottom, rb.bottom) : std::min(ra.right, rb.right);
+            const int horizontalCuts = u.height() - 1 - (stacked ? 1 : 0);
+            const int verticalCuts = u.width() - 1 - (stacked ? 0 : 1);
+            if (horizontalCuts + verticalCuts <= 0)
+            {
+                return false;
+            }
+
+            int pick = std::uniform_int_distribution<int>(0, horizontalCuts + verticalCuts - 1)(rng);
+            Rect first = u;
+            Rect second = u;
+            if (pick < horizontalCuts)
+            {
+                int cut = u.top + pick;
+                if (stacked && cut >= currentCut)
+                {
+                    ++cut;
+                }
+                first.bottom = cut;
+                second.top = cut + 1;
+            }
+            else
+            {
+                pick -= horizontalCuts;
+                int cut = u.left + pick;
+                if (!stacked && cut >= currentCut)
+                {
+                    ++cut;
+                }
+                first.right = cut;
+                second.left = cut + 1;
+            }
+
+            move.clear();
+            move.changes.push_back(RectChange{a, ra, first});
+            move.changes.push_back(RectChange{b, rb, second});
+            return true;
+        }
+    };
+}
+
+std::unique_ptr<MoveOperator> makeBorderShiftOperator()
+{
+    return std::make_unique<BorderShiftOperator>();
+}
+
+std::unique_ptr<MoveOperator> makeGuillotineSlideOperator(int maxCells)
+{
+    return std::make_unique<GuillotineSlideOperator>(maxCells);
+}
+
+std::unique_ptr<MoveOperator> makeMergeSplitOperator()
+{
+    return std::make_unique<MergeSplitOperator>();
+}
+
+std::unique_ptr<MoveOperator> makeRecutOperator()
+{
+    return std::make_unique<RecutOperator>();
+}
+
+MoveOperatorSet::MoveOperatorSet(const SAConfig &cfg)
+    : adaptive(cfg.opAdaptive),
+      adaptInterval(std::max(1, cfg.opAdaptInterval)),
+      minProbability(cfg.opMinProbability)
+{
+    // El desplazamiento de borde va primero: es el respaldo cuando otro operador no encuentra movimiento.
+    add(makeBorderShiftOperator(), cfg.opBorderWeight);
+    add(makeGuillotineSlideOperator(cfg.opSlideMaxCells), cfg.opSlideWeight);
+    add(makeMergeSplitOperator(), cfg.opMergeSplitWeight);
+    add(makeRecutOperator(), cfg.opRecutWeight);
+}
+
+void MoveOperatorSet::add(std::unique_ptr<MoveOperator> op, double weight)
+{
+    if (weight < 0.0)
+    {
+        throw std::runtime_error(std::string("Peso negativo para el operador ") + op->name());
+    }
+    ops.push_back(std::move(op));
+    weights.push_back(weight);
+    probs.push_back(0.0);
+    totalAttempts.push_back(0);
+    totalAccepted.push_back(0);
+    windowAttempts.push_back(0.0);
+    windowAccepted.push_back(0.0);
+
+    double total = 0.0;
+    for (double w : weights)
+    {
+        total += w;
+    }
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        probs[i] = total > 0.0 ? weights[i] / total : (i == 0 ? 1.0 : 0.0);
+    }
+}
+
+bool MoveOperatorSet::propose(const std::vector<Rect> &rects, const ZoneAdjacency &adjacency, Rng &rng, Move &move)
+{
+    size_t chosen = ops.size() - 1;
+    double u = uniform01(rng);
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        if (u < probs[i])
+        {
+            chosen = i;
+            break;
+        }
+        u -= probs[i];
+    }
+
+    last = chosen;
+    if (ops[chosen]->propose(rects, adjacency, rng, move))
+    {
+        return true;
+    }
+
+    // El operador elegido no encontró movimiento: cuenta como intento fallido y se usa el
+    // respaldo solo si está habilitado; si no, la iteración queda sin movimiento.
+    ++totalAttempts[chosen];
+    windowAttempts[chosen] += 1.0;
+    if (chosen == 0 || weights[0] <= 0.0)
+    {
+        return false;
+    }
+    last = 0;
+    return ops[0]->propose(rects, adjacency, rng, move);
+}
+
+void MoveOperatorSet::record(bool wasAccepted)
+{
+    ++totalAttempts[last];
+    windowAttempts[last] += 1.0;
+    if (wasAccepted)
+    {
+        ++totalAccepted[last];
+        windowAccepted[last] += 1.0;
+    }
+
+    if (adaptive && ++sinceAdapt >= adaptInterval)
+    {
+        adapt();
+        sinceAdapt = 0;
+    }
+}
+
+void MoveOperatorSet::adapt()
+{
+    // Emparejamiento de probabilidades: cada operador habilitado recibe un piso y el resto se
+    // reparte según peso * tasa de aceptación reciente (suavizada para no anular a ninguno).
+    size_t enabled = 0;
+    double total = 0.0;
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        if (weights[i] > 0.0)
+        {
+            ++enabled;
+            total += weights[i] * (windowAccepted[i] + 1.0) / (windowAttempts[i] + 2.0);
+        }
+    }
+    if (enabled == 0 || total <= 0.0)
+    {
+        return;
+    }
+
+    const double floor = std::min(minProbability, 0.5 / static_cast<double>(enabled));
+    const double rest = 1.0 - floor * static_cast<double>(enabled);
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        if (weights[i] > 0.0)
+        {
+            const double score = weights[i] * (windowAccepted[i] + 1.0) / (windowAttempts[i] + 2.0);
+            probs[i] = floor + rest * score / total;
+        }
+        else
+        {
+            probs[i] = 0.0;
+        }
+        // Olvido exponencial: pesan más las últimas ventanas.
+        windowAttempts[i] *= 0.5;
+        windowAccepted[i] *= 0.5;
+    }
+}
@@ -0,0 +1,186 @@
+#include "MultiResolution.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "EnergyTracker.hpp"
+#include "IntegralImage.hpp"
+
+namespace
+{
+    int cellsFor(int n, int factor)
+    {
+        return (n + factor - 1) / factor;
+    }
+
+    // Cantidad de niveles reducidos: la indicada o, con 0, mientras el lado menor del
+    // siguiente nivel siga >= pyramidMinSide. Nunca tan gruesos que no quepan p zonas.
+    int coarseLevels(const ProblemInstance &instance, const SAConfig &cfg)
+    {
+        constexpr int kMaxLevels = 16;
+        int levels = 0;
+        if (cfg.pyramidLevels > 0)
+        {
+            levels = std::min(cfg.pyramidLevels, kMaxLevels);
+        }
+        else
+        {
+            while (levels < kMaxLevels && std::min(cellsFor(instance.nRows, 2 << levels), cellsFor(instance.nCols, 2 << levels)) >= cfg.pyramidMinSide)
+            {
+                ++levels;
+            }
+        }
+        while (levels > 0 && static_cast<long long>(cellsFor(instance.nRows, 1 << levels)) * cellsFor(instance.nCols, 1 << levels) < instance.p)
+        {
+            --levels;
+        }
+        return levels;
+    }
+
+    // Cada celda del nivel es la media del bloque factor x factor de la grilla original
+    // (en el borde, de las celdas que queden).
+    ProblemInstance downsample(const ProblemInstance &instance, const IntegralImage &integral, int factor)
+    {
+        ProblemInstance level;
+        level.nRows = cellsFor(instance.nRows, factor);
+        level.nCols = cellsFor(instance.nCols, factor);
+        level.p = instance.p;
+        level.alpha = instance.alpha;
+        level.S.assign(level.nRows, level.nCols);
+        for (int i = 0; i < level.nRows; ++i)
+        {
+            for (int j = 0; j < level.nCols; ++j)
+            {
+                const Rect block{i * factor, std::min((i + 1) * factor, instance.nRows) - 1,
+                                 j * factor, std::min((j + 1) * factor, instance.nCols) - 1};
+                level.S[i][j] = integral.mean(block);
+            }
+        }
+        return level;
+    }
+
+    // Proyecta una partición a una grilla 'ratio' veces más fina de rows x cols celdas.
+    // Los niveles usan ceil(n / factor) celdas por lado, así que el mosaico se conserva.
+    std::vector<Rect> projectRects(const std::vector<Rect> &rects, int ratio, int rows, int cols)
+    {
+        std::vector<Rect> out;
+        out.reserve(rects.size());
+        for (const Rect &r : rects)
+        {
+            out.push_back(Rect{r.top * ratio, std::min((r.bottom + 1) * ratio, rows) - 1,
+                               r.left * ratio, std::min((r.right + 1) * ratio, cols) - 1});
+        }
+        return out;
+    }
+
+    // Suma los contadores y tiempos por etapa de un nivel en el total.
+    void accumulate(SATelemetry &total, const SATelemetry &level)
+    {
+        total.proposals += level.proposals;
+        total.proposalFailures += level.proposalFailures;
+        total.metropolisAccepts += level.metropolisAccepts;
+        total.metropolisRejects += level.metropolisRejects;
+        total.improvements += level.improvements;
+        total.setupSeconds += level.setupSeconds;
+        total.startSeconds += level.startSeconds;
+        total.t0Seconds += level.t0Seconds;
+        total.loopSeconds += level.loopSeconds;
+        total.phases.proposeSeconds += level.phases.proposeSeconds;
+        total.phases.evaluateSeconds += level.phases.evaluateSeconds;
+        total.phases.commitSeconds += level.phases.commitSeconds;
+    }
+}
+
+Solution multiResolutionAnnealing(const ProblemInstance &instance, const SAConfig &cfg, Rng &rng, Solution *initialOut, SAStats *stats)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+    auto secondsSince = [](Clock::time_point t)
+    { return std::chrono::duration<double>(Clock::now() - t).count(); };
+
+    const int levels = coarseLevels(instance, cfg);
+    if (levels == 0)
+    {
+        return simulatedAnnealing(instance, cfg, rng, initialOut, stats);
+    }
+
+    const IntegralImage integral(instance);
+    const double coarseShare = (1.0 - cfg.pyramidFineShare) / levels;
+
+    Solution current;
+    Solution coarseInitial;
+    SAStats total;
+    double fullScaleT0 = 0.0; // T0 del nivel más grueso llevada a la escala de la grilla completa
+    for (int level = levels; level >= 0; --level)
+    {
+        const auto levelStart = Clock::now();
+        const int factor = 1 << level;
+        const ProblemInstance reduced = level > 0 ? downsample(instance, integral, factor) : ProblemInstance();
+        const ProblemInstance &grid = level > 0 ? reduced : instance;
+
+        // La energía de un nivel es ~1/factor² la de la grilla completa: T0 y Tf se escalan igual.
+        const double scale = 1.0 / (static_cast<double>(factor) * factor);
+        const double share = level > 0 ? coarseShare : cfg.pyramidFineShare;
+        SAConfig levelCfg = cfg;
+        levelCfg.maxTimeSeconds = cfg.maxTimeSeconds * share;
+        levelCfg.maxIterations = std::max(1, static_cast<int>(cfg.maxIterations * share));
+        levelCfg.Tf = cfg.Tf * scale;
+        levelCfg.targetEnergy = level == 0 ? cfg.targetEnergy : -1.0; // solo comparable a resolución completa
+        levelCfg.traceInterval = level == 0 ? cfg.traceInterval : 0;
+
+        SAStats levelStats;
+        if (level == levels)
+        {
+            levelCfg.T0 = cfg.T0 * scale;
+            current = simulatedAnnealing(grid, levelCfg, rng, &coarseInitial, &levelStats);
+            fullScaleT0 = levelStats.initialTemperature / scale;
+            total.initialTemperature = levelStats.initialTemperature;
+            total.telemetry.start = levelStats.telemetry.start;
+        }
+        else
+        {
+            const Solution projected{projectRects(current.rects, 2, grid.nRows, grid.nCols), 0.0};
+            levelCfg.autoT0 = false;
+            levelCfg.T0 = fullScaleT0 * cfg.pyramidRefineT0 * scale;
+            current = simulatedAnnealing(grid, levelCfg, rng, nullptr, &levelStats, &projected);
+        }
+
+        total.iterations += levelStats.iterations;
+        total.accepted += levelStats.accepted;
+        total.improvements += levelStats.improvements;
+        total.reheats += levelStats.reheats;
+        accumulate(total.telemetry, levelStats.telemetry);
+        if (level == 0)
+        {
+            const double offset = std::chrono::duration<double>(levelStart - startTime).count();
+            total.timeToTarget = levelStats.timeToTarget >= 0.0 ? offset + levelStats.timeToTarget : -1.0;
+            total.bestEnergy = levelStats.bestEnergy;
+            total.telemetry.operators = std::move(levelStats.telemetry.operators);
+            total.telemetry.trace = std::move(levelStats.telemetry.trace);
+        }
+        total.telemetry.levels.push_back(LevelTelemetry{grid.nRows, grid.nCols, factor, levelStats.iterations,
+                                                        levelStats.initialEnergy, levelStats.bestEnergy, secondsSince(levelStart)});
+    }
+
+    if (initialOut || stats)
+    {
+        // Partida del nivel más grueso llevada a la resolución completa.
+        Solution initial{projectRects(coarseInitial.rects, 1 << levels, instance.nRows, instance.nCols), 0.0};
+        EnergyTracker tracker(instance, calculateTotalVariance(instance), cfg.penaltyWeight);
+        tracker.reset(integral, initial.rects);
+        initial.errorTotal = tracker.error();
+        total.initialEnergy = tracker.energy();
+        if (initialOut)
+        {
+            *initialOut = std::move(initial);
+        }
+    }
+    if (stats)
+    {
+        total.elapsedSeconds = secondsSince(startTime);
+        *stats = std::move(total);
+    }
+    return current;
+}
@@ -0,0 +1,95 @@
+#include "OutputQueue.hpp"
+
+#include <algorithm>
+
+OutputQueue::OutputQueue(int threads, std::size_t capacity)
+    : capacity(std::max<std::size_t>(1, capacity))
+{
+    threads = std::max(1, threads);
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(&OutputQueue::run, this);
+    }
+}
+
+OutputQueue::~OutputQueue()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [&] { return tasks.empty() && running == 0; });
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+}
+
+void OutputQueue::submit(Task task)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return tasks.size() < capacity; });
+        tasks.push_back(std::move(task));
+    }
+    notEmpty.notify_one();
+}
+
+void OutputQueue::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [&] { return tasks.empty() && running == 0; });
+    if (error)
+    {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void OutputQueue::run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [&] { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return; // stopping y sin trabajo pendiente
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++running;
+        }
+        notFull.notify_one();
+
+        std::exception_ptr failure;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+
+        bool nowIdle = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failure && !error)
+            {
+                error = failure;
+            }
+            --running;
+            nowIdle = tasks.empty() && running == 0;
+        }
+        if (nowIdle)
+        {
+            idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "ParallelSA.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "MultiResolution.hpp"
+#include "Seeding.hpp"
+
+namespace
+{
+    int resolveThreads(const SAConfig &cfg, int chains)
+    {
+        int threads = cfg.threads;
+        if (threads <= 0)
+        {
+            threads = static_cast<int>(std::thread::hardware_concurrency());
+        }
+        return std::max(1, std::min(threads, chains));
+    }
+}
+
+Solution parallelSimulatedAnnealing(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *chainStats, Solution *initialOut)
+{
+    const int chains = std::max(1, cfg.chains);
+    const int threads = resolveThreads(cfg, chains);
+
+    // El presupuesto total se reparte entre las "tandas" de cadenas que ejecuta cada hilo.
+    SAConfig chainCfg = cfg;
+    if (cfg.totalTimeSeconds > 0.0)
+    {
+        const int waves = (chains + threads - 1) / threads;
+        chainCfg.maxTimeSeconds = cfg.totalTimeSeconds / waves;
+    }
+
+    // Partida determinista: se calcula una vez y se copia a cada cadena. "pyramid" siembra
+    // sobre su nivel más grueso, dentro de cada cadena.
+    const bool sharedSeed = cfg.mode != "pyramid" && isSharedSeeding(cfg);
+    const Solution seed = sharedSeed ? buildSharedSeed(instance, IntegralImage(instance), calculateTotalVariance(instance), cfg) : Solution();
+
+    std::vector<Solution> bests(chains);
+    std::vector<Solution> initials(chains);
+    std::vector<SAStats> stats(chains);
+
+    std::atomic<int> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (int c = next++; c < chains; c = next++)
+        {
+            try
+            {
+                Rng rng = makeChainRng(cfg, static_cast<unsigned>(c));
+                bests[c] = cfg.mode == "pyramid" ? multiResolutionAnnealing(instance, chainCfg, rng, &initials[c], &stats[c])
+                                                 : simulatedAnnealing(instance, chainCfg, rng, &initials[c], &stats[c], nullptr, sharedSeed ? &seed : nullptr);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    // Reducción: mejor energía (error + penalización) entre todas las cadenas.
+    int winner = 0;
+    for (int c = 1; c < chains; ++c)
+    {
+        if (stats[c].bestEnergy < stats[winner].bestEnergy)
+        {
+            winner = c;
+        }
+    }
+
+    if (chainStats)
+    {
+        *chainStats = stats;
+    }
+    if (initialOut)
+    {
+        *initialOut = std::move(initials[winner]);
+    }
+    return std::move(bests[winner]);
+}
@@ -0,0 +1,223 @@
+#include "ParallelTempering.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "AnnealingChain.hpp"
+#include "Seeding.hpp"
+
+namespace
+{
+    // Barrera reutilizable: el último hilo en llegar ejecuta 'onComplete' antes de liberar al resto.
+    class Barrier
+    {
+    public:
+        explicit Barrier(int count) : count(count), waiting(0), generation(0) {}
+
+        template <typename F>
+        void arriveAndWait(F &&onComplete)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const long long gen = generation;
+            if (++waiting == count)
+            {
+                onComplete();
+                waiting = 0;
+                ++generation;
+                cv.notify_all();
+                return;
+            }
+            cv.wait(lock, [&] { return gen != generation; });
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        const int count;
+        int waiting;
+        long long generation;
+    };
+
+    // Temperaturas de menor a mayor según cfg.ptSpacing ("geometric" o "linear").
+    std::vector<double> buildLadder(const SAConfig &cfg, int replicas)
+    {
+        std::vector<double> ladder(replicas, cfg.ptTMin);
+        for (int k = 1; k < replicas; ++k)
+        {
+            const double t = static_cast<double>(k) / (replicas - 1);
+            if (cfg.ptSpacing == "linear")
+            {
+                ladder[k] = cfg.ptTMin + t * (cfg.ptTMax - cfg.ptTMin);
+            }
+            else
+            {
+                ladder[k] = cfg.ptTMin * std::pow(cfg.ptTMax / cfg.ptTMin, t);
+            }
+        }
+        return ladder;
+    }
+}
+
+Solution parallelTempering(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *replicaStats, Solution *initialOut)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    const int replicas = std::max(1, cfg.ptReplicas);
+    const int swapInterval = std::max(1, cfg.ptSwapInterval);
+    const double timeBudget = cfg.totalTimeSeconds > 0.0 ? cfg.totalTimeSeconds : cfg.maxTimeSeconds;
+    const std::vector<double> ladder = buildLadder(cfg, replicas);
+
+    const double totalVariance = calculateTotalVariance(instance);
+    const IntegralImage integral(instance);
+    const double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::vector<Rng> rngs;
+    std::vector<Solution> initials(replicas);
+    std::vector<StartTelemetry> starts(replicas);
+    std::vector<std::unique_ptr<AnnealingChain>> chains;
+    const auto startPhase = std::chrono::steady_clock::now();
+    const bool sharedSeed = isSharedSeeding(cfg);
+    const Solution seed = sharedSeed ? buildSharedSeed(instance, integral, totalVariance, cfg) : Solution();
+    for (int r = 0; r < replicas; ++r)
+    {
+        rngs.push_back(makeChainRng(cfg, static_cast<unsigned>(r)));
+        initials[r] = buildStartingSolution(instance, integral, totalVariance, cfg, rngs[r], &starts[r], sharedSeed ? &seed : nullptr);
+        chains.push_back(std::make_unique<AnnealingChain>(instance, integral, totalVariance, cfg));
+        chains[r]->reset(initials[r]);
+    }
+    std::vector<double> initialEnergies(replicas);
+    for (int r = 0; r < replicas; ++r)
+    {
+        initialEnergies[r] = chains[r]->energy();
+    }
+    const double startSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startPhase).count();
+    const auto loopPhase = std::chrono::steady_clock::now();
+
+    // replicaAt[k] = réplica que está en el escalón k; rungOf es la inversa.
+    std::vector<int> replicaAt(replicas), rungOf(replicas);
+    for (int k = 0; k < replicas; ++k)
+    {
+        replicaAt[k] = rungOf[k] = k;
+    }
+
+    Rng swapRng = makeChainRng(cfg, static_cast<unsigned>(replicas));
+    std::uniform_real_distribution<double> uniform01(0.0, 1.0);
+    long long rounds = 0;
+    bool stop = false;
+
+    // Lo ejecuta un único hilo mientras los demás esperan en la barrera.
+    auto exchange = [&]() {
+        // Escalones pares e impares alternados para no intentar dos veces la misma réplica.
+        for (int k = static_cast<int>(rounds % 2); k + 1 < replicas; k += 2)
+        {
+            const int a = replicaAt[k];
+            const int b = replicaAt[k + 1];
+            const double x = (1.0 / ladder[k] - 1.0 / ladder[k + 1]) * (chains[a]->energy() - chains[b]->energy());
+            if (x >= 0.0 || uniform01(swapRng) < std::exp(x))
+            {
+                std::swap(replicaAt[k], replicaAt[k + 1]);
+                rungOf[a] = k + 1;
+                rungOf[b] = k;
+            }
+        }
+        ++rounds;
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        const bool outOfIterations = rounds * swapInterval >= cfg.maxIterations;
+        stop = (timeBudget > 0.0 && elapsed >= timeBudget) || (timeBudget <= 0.0 && outOfIterations);
+    };
+
+    Barrier barrier(replicas);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&](int r) {
+        AnnealingChain &chain = *chains[r];
+        while (true)
+        {
+            try
+            {
+                const double temperature = ladder[rungOf[r]];
+                for (int i = 0; i < swapInterval; ++i)
+                {
+                    chain.step(temperature, rngs[r]);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            barrier.arriveAndWait([&] {
+                exchange();
+                if (error)
+                {
+                    stop = true;
+                }
+            });
+            if (stop)
+            {
+                break;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(replicas);
+    for (int r = 0; r < replicas; ++r)
+    {
+        pool.emplace_back(worker, r);
+    }
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    int winner = 0;
+    for (int r = 1; r < replicas; ++r)
+    {
+        if (chains[r]->bestEnergy() < chains[winner]->bestEnergy())
+        {
+            winner = r;
+        }
+    }
+
+    if (replicaStats)
+    {
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        replicaStats->assign(replicas, SAStats{});
+        for (int r = 0; r < replicas; ++r)
+        {
+            SAStats &st = (*replicaStats)[r];
+            st.iterations = chains[r]->iterations();
+            st.accepted = chains[r]->accepted();
+            st.improvements = chains[r]->improvements();
+            st.initialEnergy = initialEnergies[r];
+            st.bestEnergy = chains[r]->bestEnergy();
+            st.elapsedSeconds = elapsed;
+            chains[r]->fillTelemetry(st.telemetry);
+            st.telemetry.start = starts[r];
+            st.telemetry.setupSeconds = setupSeconds;
+            st.telemetry.startSeconds = startSeconds;
+            st.telemetry.loopSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopPhase).count();
+        }
+    }
+    if (initialOut)
+    {
+        *initialOut = initials[winner];
+    }
+    return chains[winner]->best();
+}
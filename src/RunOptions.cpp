@@ -0,0 +1,248 @@
+#include "RunOptions.hpp"
+
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    int parseInt(const std::string &flag, const std::string &value)
+    {
+        try
+        {
+            size_t used = 0;
+            int v = std::stoi(value, &used);
+            if (used == value.size())
+            {
+                return v;
+            }
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::runtime_error("Valor invalido para " + flag + ": " + value);
+    }
+
+    long long parseLong(const std::string &flag, const std::string &value)
+    {
+        try
+        {
+            size_t used = 0;
+            long long v = std::stoll(value, &used);
+            if (used == value.size())
+            {
+                return v;
+            }
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::runtime_error("Valor invalido para " + flag + ": " + value);
+    }
+
+    double parseDouble(const std::string &flag, const std::string &value)
+    {
+        try
+        {
+            size_t used = 0;
+            double v = std::stod(value, &used);
+            if (used == value.size())
+            {
+                return v;
+            }
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::runtime_error("Valor invalido para " + flag + ": " + value);
+    }
+}
+
+RunOptions parseCommandLine(int argc, char *argv[])
+{
+    RunOptions opts;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0)
+        {
+            if (!opts.instancePath.empty())
+            {
+                throw std::runtime_error("Solo se admite una instancia: " + opts.instancePath + " y " + arg);
+            }
+            opts.instancePath = arg;
+            continue;
+        }
+
+        std::string flag = arg;
+        std::string value;
+        bool hasValue = false;
+        const size_t eq = arg.find('=');
+        if (eq != std::string::npos)
+        {
+            flag = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+            hasValue = true;
+        }
+
+        if (flag == "--help" || flag == "-h")
+        {
+            opts.showHelp = true;
+            continue;
+        }
+
+        static const char *const valueFlags[] = {"--p", "--alpha", "--seed", "--config", "--out-dir", "--time", "--threads", "--trace", "--batch", "--convert", "--dtype", "--heatmap-max-dim", "--heatmap-format"};
+        bool known = false;
+        for (const char *f : valueFlags)
+        {
+            known = known || flag == f;
+        }
+        if (!known)
+        {
+            throw std::runtime_error("Opcion desconocida: " + flag + " (use --help)");
+        }
+
+        if (!hasValue)
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Falta el valor de " + flag);
+            }
+            value = argv[++i];
+        }
+
+        if (flag == "--p")
+        {
+            opts.p = parseInt(flag, value);
+            if (opts.p <= 0)
+            {
+                throw std::runtime_error("p debe ser un entero positivo.");
+            }
+        }
+        else if (flag == "--alpha")
+        {
+            opts.alpha = parseDouble(flag, value);
+            if (opts.alpha <= 0.0 || opts.alpha > 1.0)
+            {
+                throw std::runtime_error("alpha debe estar en ]0,1].");
+            }
+        }
+        else if (flag == "--seed")
+        {
+            opts.seed = parseLong(flag, value);
+            if (opts.seed < 0)
+            {
+                throw std::runtime_error("La semilla debe ser no negativa.");
+            }
+        }
+        else if (flag == "--config")
+        {
+            opts.configPath = value;
+        }
+        else if (flag == "--out-dir")
+        {
+            opts.outputDir = value;
+        }
+        else if (flag == "--time")
+        {
+            opts.timeSeconds = parseDouble(flag, value);
+            if (opts.timeSeconds < 0.0)
+            {
+                throw std::runtime_error("El tiempo debe ser no negativo (0 = sin limite).");
+            }
+        }
+        else if (flag == "--threads")
+        {
+            opts.threads = parseInt(flag, value);
+            if (opts.threads < 0)
+            {
+                throw std::runtime_error("La cantidad de hilos debe ser no negativa (0 = nucleos disponibles).");
+            }
+        }
+        else if (flag == "--trace")
+        {
+            opts.traceInterval = parseInt(flag, value);
+            if (opts.traceInterval < 0)
+            {
+                throw std::runtime_error("El intervalo de la traza debe ser no negativo (0 = sin traza).");
+            }
+        }
+        else if (flag == "--batch")
+        {
+            opts.batchManifest = value;
+        }
+        else if (flag == "--convert")
+        {
+            opts.convertTo = value;
+        }
+        else if (flag == "--heatmap-max-dim")
+        {
+            opts.heatmapMaxDim = parseInt(flag, value);
+            if (opts.heatmapMaxDim < 0)
+            {
+                throw std::runtime_error("--heatmap-max-dim debe ser no negativo (0 = resolucion completa).");
+            }
+        }
+        else if (flag == "--heatmap-format")
+        {
+            if (value != "png" && value != "ppm")
+            {
+                throw std::runtime_error("--heatmap-format debe ser png o ppm.");
+            }
+            opts.heatmapFormat = value;
+        }
+        else // --dtype
+        {
+            if (value != "float32" && value != "float64")
+            {
+                throw std::runtime_error("--dtype debe ser float32 o float64.");
+            }
+            opts.dtype = value;
+        }
+    }
+
+    return opts;
+}
+
+void applyCommandLineOverrides(const RunOptions &opts, SAConfig &cfg)
+{
+    if (opts.seed >= 0)
+    {
+        cfg.seed = static_cast<unsigned long long>(opts.seed);
+    }
+    if (opts.timeSeconds >= 0.0)
+    {
+        cfg.totalTimeSeconds = opts.timeSeconds;
+        cfg.maxTimeSeconds = opts.timeSeconds;
+    }
+    if (opts.threads >= 0)
+    {
+        cfg.threads = opts.threads;
+    }
+    if (opts.traceInterval >= 0)
+    {
+        cfg.traceInterval = opts.traceInterval;
+    }
+}
+
+void printUsage(std::ostream &out, const std::string &program)
+{
+    out << "Uso: " << program << " [instancia] [opciones]\n"
+        << "     " << program << " --batch manifiesto [opciones]\n"
+        << "\n"
+        << "  instancia          nombre (grande_1), nombre con extension o ruta; por defecto instance.spp\n"
+        << "  --p N              cantidad de zonas (si falta: clave \"p\" del JSON o consola)\n"
+        << "  --alpha A          nivel de homogeneidad en ]0,1] (si falta: clave \"alpha\" del JSON o consola)\n"
+        << "  --seed S           semilla de los generadores (0 = aleatoria)\n"
+        << "  --config RUTA      archivo de configuracion (por defecto data/config/default.json)\n"
+        << "  --out-dir DIR      directorio de salida (por defecto data/solutions)\n"
+        << "  --time SEG         presupuesto de tiempo total en segundos (0 = sin limite)\n"
+        << "  --threads N        hilos de trabajo (0 = nucleos disponibles)\n"
+        << "  --trace N          muestrea T, energia y mejor energia cada N iteraciones en el .stats.json\n"
+        << "  --batch RUTA       resuelve los trabajos del manifiesto (lineas \"instancia p alpha\")\n"
+        << "  --convert RUTA     convierte la instancia al formato binario .sppb y termina\n"
+        << "  --dtype TIPO       tipo de los valores en el .sppb: float64 (por defecto) o float32\n"
+        << "  --heatmap-max-dim N  lado maximo del heatmap en pixeles; si se supera, vista previa (4096; 0 = sin limite)\n"
+        << "  --heatmap-format F   png (por defecto) o ppm (se escribe por franjas, sin la imagen entera en memoria)\n"
+        << "  --help             muestra esta ayuda\n";
+}
@@ -1,126 +1,105 @@
 #include "SA.hpp"
 
 #include <chrono>
-#include <cmath>
 #include <random>
+#include <utility>
+
+#include "AnnealingChain.hpp"
+#include "Schedule.hpp"
+
+Rng makeChainRng(const SAConfig &cfg, unsigned stream)
+{
+    // Todas las cadenas parten de la misma semilla; cada una avanza 'stream' saltos de 2^128.
+    const Rng root(cfg.seed != 0 ? cfg.seed : randomSeed());
+    return root.stream(stream);
+}
 
 Solution simulatedAnnealing(const ProblemInstance &instance, const SAConfig &cfg, Solution *initialOut)
 {
-    Solution current = buildInitialSolution(instance);
-    double totalVariance = calculateTotalVariance(instance);
+    Rng rng = makeChainRng(cfg, 0);
+    return simulatedAnnealing(instance, cfg, rng, initialOut);
+}
 
-    std::mt19937 rng(std::random_device{}());
+Solution simulatedAnnealing(const ProblemInstance &instance, const SAConfig &cfg, Rng &rng, Solution *initialOut, SAStats *stats, const Solution *start, const Solution *seed)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+    auto secondsSince = [](Clock::time_point t)
+    { return std::chrono::duration<double>(Clock::now() - t).count(); };
+    SATelemetry telemetry;
 
-    // Intentar encontrar una solución inicial válida si la partición por franjas no cumple restricciones
-    if (!isSolutionValid(instance, current.Z, totalVariance))
-    {
-        std::vector<std::vector<int>> neighborZ;
-        for (int attempt = 0; attempt < 1000; ++attempt)
-        {
-            if (!generateNeighbor(instance, current.Z, neighborZ, rng))
-            {
-                continue;
-            }
-            if (isSolutionValid(instance, neighborZ, totalVariance))
-            {
-                std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
-                std::vector<int> counts(instance.p + 1, 0);
-                current.errorTotal = calculateErrorAndVariance(instance, neighborZ, means, variances, counts);
-                current.Z = neighborZ;
-                break;
-            }
-        }
-    }
+    double totalVariance = calculateTotalVariance(instance);
+    const IntegralImage integral(instance);
+    telemetry.setupSeconds = secondsSince(startTime);
 
+    const auto startPhase = Clock::now();
+    Solution initial = start ? *start : buildStartingSolution(instance, integral, totalVariance, cfg, rng, &telemetry.start, seed);
     if (initialOut)
     {
-        *initialOut = current;
+        *initialOut = initial;
     }
 
-    std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
-    std::vector<int> counts(instance.p + 1, 0);
-    calculateErrorAndVariance(instance, current.Z, means, variances, counts);
-    double currentPenalty = calculateVariancePenalty(instance, variances, counts, totalVariance);
-    double currentEnergy = current.errorTotal + cfg.penaltyWeight * currentPenalty;
+    AnnealingChain chain(instance, integral, totalVariance, cfg);
+    chain.reset(initial);
+    const double initialEnergy = chain.energy();
+    telemetry.startSeconds = secondsSince(startPhase);
 
-    Solution best = current;
-    double bestEnergy = currentEnergy;
+    const auto t0Phase = Clock::now();
+    const double T0 = cfg.autoT0 ? estimateInitialTemperature(chain, cfg, rng) : cfg.T0;
+    telemetry.t0Seconds = secondsSince(t0Phase);
+    CoolingSchedule schedule(cfg, T0, startTime);
 
-    double temperature = cfg.T0;
-    int iterations = 0;
-
-    std::uniform_real_distribution<double> uniform01(0.0, 1.0);
+    double timeToTarget = -1.0;
+    auto reachedTarget = [&]()
+    { return cfg.targetEnergy >= 0.0 && timeToTarget < 0.0 && chain.bestEnergy() <= cfg.targetEnergy; };
+    if (reachedTarget())
+    {
+        timeToTarget = secondsSince(startTime);
+    }
 
-    const auto startTime = std::chrono::steady_clock::now();
+    auto sampleTrace = [&]()
+    { telemetry.trace.push_back({secondsSince(startTime), chain.iterations(), schedule.temperature(), chain.energy(), chain.bestEnergy()}); };
+    if (cfg.traceInterval > 0)
+    {
+        sampleTrace();
+    }
 
-    auto timeExceeded = [&]() {
-        if (cfg.maxTimeSeconds <= 0.0)
+    const auto loopPhase = Clock::now();
+    while (!schedule.finished())
+    {
+        const long long improvementsBefore = chain.improvements();
+        const bool accepted = chain.step(schedule.temperature(), rng);
+        const bool improved = chain.improvements() != improvementsBefore;
+        schedule.observe(accepted, improved);
+        if (improved && reachedTarget())
         {
-            return false;
+            timeToTarget = secondsSince(startTime);
         }
-        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
-        return elapsed >= cfg.maxTimeSeconds;
-    };
-
-    while (temperature > cfg.Tf && iterations < cfg.maxIterations && !timeExceeded())
-    {
-        for (int i = 0; i < cfg.itersPerTemp && iterations < cfg.maxIterations && !timeExceeded(); ++i)
+        if (cfg.traceInterval > 0 && chain.iterations() % cfg.traceInterval == 0)
         {
-            ++iterations;
-            std::vector<std::vector<int>> neighborZ;
-            if (!generateNeighbor(instance, current.Z, neighborZ, rng))
-            {
-                continue;
-            }
-
-            if (!isPartitionConnected(instance, neighborZ))
-            {
-                continue;
-            }
-
-            // Reparación: si hay zonas en L, intentar forzar rectángulos sin solape; si falla, descartar.
-            std::vector<std::vector<int>> repairedZ = neighborZ;
-            if (!makeRectsIfNonOverlapping(instance, repairedZ))
-            {
-                continue;
-            }
-            neighborZ.swap(repairedZ);
-
-            std::vector<double> nMeans(instance.p + 1, 0.0), nVariances(instance.p + 1, 0.0);
-            std::vector<int> nCounts(instance.p + 1, 0);
-            double neighborError = calculateErrorAndVariance(instance, neighborZ, nMeans, nVariances, nCounts);
-            double neighborPenalty = calculateVariancePenalty(instance, nVariances, nCounts, totalVariance);
-            double neighborEnergy = neighborError + cfg.penaltyWeight * neighborPenalty;
-            double delta = neighborEnergy - currentEnergy;
-
-            bool accept = false;
-            if (delta < 0)
-            {
-                accept = true;
-            }
-            else
-            {
-                double prob = std::exp(-delta / temperature);
-                accept = uniform01(rng) < prob;
-            }
-
-            if (accept)
-            {
-                current.Z = std::move(neighborZ);
-                current.errorTotal = neighborError;
-                currentPenalty = neighborPenalty;
-                currentEnergy = neighborEnergy;
-            }
-
-            if (currentEnergy < bestEnergy)
-            {
-                best = current;
-                bestEnergy = currentEnergy;
-            }
+            sampleTrace();
         }
+    }
+    telemetry.loopSeconds = secondsSince(loopPhase);
+    if (cfg.traceInterval > 0 && (telemetry.trace.empty() || telemetry.trace.back().iteration != chain.iterations()))
+    {
+        sampleTrace();
+    }
 
-        temperature *= cfg.coolingFactor;
+    if (stats)
+    {
+        stats->iterations = chain.iterations();
+        stats->accepted = chain.accepted();
+        stats->improvements = chain.improvements();
+        stats->initialTemperature = T0;
+        stats->reheats = schedule.reheats();
+        stats->timeToTarget = timeToTarget;
+        stats->initialEnergy = initialEnergy;
+        stats->bestEnergy = chain.bestEnergy();
+        stats->elapsedSeconds = secondsSince(startTime);
+        chain.fillTelemetry(telemetry);
+        stats->telemetry = std::move(telemetry);
     }
 
-    return best;
+    return chain.best();
 }
@@ -0,0 +1,174 @@
+#include "Schedule.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "AnnealingChain.hpp"
+
+namespace
+{
+    // Tasa de aceptación objetivo de Modified Lam (Boyan) según la fracción f del presupuesto:
+    // cae de 1 a 0.44 en el primer 15%, se mantiene hasta el 65% y luego decae exponencialmente.
+    double lamTarget(double f)
+    {
+        if (f < 0.15)
+        {
+            return 0.44 + 0.56 * std::pow(560.0, -f / 0.15);
+        }
+        if (f < 0.65)
+        {
+            return 0.44;
+        }
+        return 0.44 * std::pow(440.0, -(f - 0.65) / 0.35);
+    }
+
+    // Cada cuántas iteraciones se consulta el reloj.
+    constexpr long long kClockInterval = 64;
+}
+
+CoolingSchedule::CoolingSchedule(const SAConfig &cfg, double initialTemperature, Clock::time_point start)
+    : T0(initialTemperature),
+      Tf(cfg.Tf),
+      T(initialTemperature),
+      coolingFactor(cfg.coolingFactor),
+      itersPerTemp(std::max(1, cfg.itersPerTemp)),
+      maxIterations(cfg.maxIterations),
+      budgetSeconds(cfg.maxTimeSeconds),
+      startTime(start),
+      segStartT(initialTemperature),
+      reheatStagnation(cfg.reheatStagnation),
+      reheatFactor(cfg.reheatFactor)
+{
+    if (cfg.schedule == "geometric")
+    {
+        kind = Kind::Geometric;
+    }
+    else if (cfg.schedule == "geometric_time")
+    {
+        kind = Kind::GeometricTime;
+    }
+    else if (cfg.schedule == "lam")
+    {
+        kind = Kind::Lam;
+    }
+    else
+    {
+        throw std::runtime_error("Programa de temperaturas desconocido: " + cfg.schedule);
+    }
+
+    if (kind != Kind::Geometric)
+    {
+        if (budgetSeconds <= 0.0)
+        {
+            throw std::runtime_error("El programa \"" + cfg.schedule + "\" requiere max_time_seconds > 0");
+        }
+        // Con T0 estimado puede quedar por debajo de Tf: la curva necesita Tf < T0.
+        if (Tf <= 0.0 || Tf >= T0)
+        {
+            Tf = T0 * 1e-3;
+        }
+    }
+}
+
+bool CoolingSchedule::finished() const
+{
+    if (budgetSeconds > 0.0 && fraction >= 1.0)
+    {
+        return true;
+    }
+    return kind == Kind::Geometric && (T <= Tf || iterCount >= maxIterations);
+}
+
+void CoolingSchedule::refreshClock()
+{
+    if (budgetSeconds > 0.0)
+    {
+        fraction = std::chrono::duration<double>(Clock::now() - startTime).count() / budgetSeconds;
+    }
+    else if (maxIterations > 0)
+    {
+        // Sin presupuesto de tiempo (solo "geometric"): la fracción es la de iteraciones,
+        // para que el recalentamiento por estancamiento siga funcionando.
+        fraction = static_cast<double>(iterCount) / static_cast<double>(maxIterations);
+    }
+}
+
+void CoolingSchedule::observe(bool accepted, bool improvedBest)
+{
+    ++iterCount;
+    if (improvedBest)
+    {
+        lastImprovementF = fraction;
+    }
+
+    const bool tick = iterCount % kClockInterval == 0;
+    if (tick)
+    {
+        refreshClock();
+    }
+
+    switch (kind)
+    {
+    case Kind::Geometric:
+        if (iterCount % itersPerTemp == 0)
+        {
+            T *= coolingFactor;
+        }
+        break;
+    case Kind::GeometricTime:
+        if (tick && segStartF < 1.0)
+        {
+            const double progress = std::min(1.0, (fraction - segStartF) / (1.0 - segStartF));
+            T = segStartT * std::pow(Tf / segStartT, progress);
+        }
+        break;
+    case Kind::Lam:
+        // El controlador se acota a [Tf, T0]: con objetivos cercanos a 1 la temperatura
+        // crecería sin límite y luego tardaría todo el presupuesto en volver a bajar.
+        acceptRate = 0.998 * acceptRate + 0.002 * (accepted ? 1.0 : 0.0);
+        if (acceptRate > lamTarget(fraction))
+        {
+            T = std::max(Tf, T * 0.999);
+        }
+        else
+        {
+            T = std::min(T0, T / 0.999);
+        }
+        break;
+    }
+
+    if (tick && reheatStagnation > 0.0 && fraction - lastImprovementF >= reheatStagnation)
+    {
+        T = std::min(T0, T * reheatFactor);
+        segStartT = std::max(T, Tf);
+        segStartF = fraction;
+        lastImprovementF = fraction;
+        ++reheatCount;
+    }
+}
+
+double estimateInitialTemperature(AnnealingChain &chain, const SAConfig &cfg, Rng &rng)
+{
+    if (cfg.autoT0Acceptance <= 0.0 || cfg.autoT0Acceptance >= 1.0)
+    {
+        throw std::runtime_error("auto_t0_acceptance debe estar en (0, 1)");
+    }
+
+    double uphillSum = 0.0;
+    int uphillCount = 0;
+    for (int s = 0; s < cfg.autoT0Samples; ++s)
+    {
+        double delta = 0.0;
+        if (chain.sampleDelta(rng, delta) && delta > 0.0)
+        {
+            uphillSum += delta;
+            ++uphillCount;
+        }
+    }
+    if (uphillCount == 0)
+    {
+        return cfg.T0;
+    }
+    return -(uphillSum / uphillCount) / std::log(cfg.autoT0Acceptance);
+}
@@ -0,0 +1,328 @@
+#include "Seeding.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "GuillotineDP.hpp"
+
+namespace
+{
+    // Energía de una zona: mismo criterio que EnergyTracker (SSE + penaltyWeight * exceso de varianza).
+    class ZoneCost
+    {
+    public:
+        ZoneCost(const IntegralImage &integral, double maxVariance, double penaltyWeight)
+            : integral(integral), maxVariance(maxVariance), penaltyWeight(penaltyWeight)
+        {
+        }
+
+        double operator()(const Rect &r) const
+        {
+            const double sse = integral.sse(r);
+            const double variance = sse / static_cast<double>(r.area());
+            return sse + penaltyWeight * (variance > maxVariance ? variance - maxVariance : 0.0);
+        }
+
+    private:
+        const IntegralImage &integral;
+        double maxVariance;
+        double penaltyWeight;
+    };
+
+    // Corte de un rectángulo en dos partes y la energía de cada una.
+    struct Cut
+    {
+        Rect first;
+        Rect second;
+        double firstEnergy = 0.0;
+        double secondEnergy = 0.0;
+
+        double energy() const { return firstEnergy + secondEnergy; }
+    };
+
+    // Los 'k' cortes de r de menor energía conjunta, en orden creciente.
+    void bestCuts(const Rect &r, const ZoneCost &cost, int k, std::vector<Cut> &out)
+    {
+        out.clear();
+        for (int cut = r.top + 1; cut <= r.bottom; ++cut)
+        {
+            const Rect a{r.top, cut - 1, r.left, r.right};
+            const Rect b{cut, r.bottom, r.left, r.right};
+            out.push_back(Cut{a, b, cost(a), cost(b)});
+        }
+        for (int cut = r.left + 1; cut <= r.right; ++cut)
+        {
+            const Rect a{r.top, r.bottom, r.left, cut - 1};
+            const Rect b{r.top, r.bottom, cut, r.right};
+            out.push_back(Cut{a, b, cost(a), cost(b)});
+        }
+        const auto byEnergy = [](const Cut &x, const Cut &y)
+        { return x.energy() < y.energy(); };
+        const std::size_t keep = std::min(out.size(), static_cast<std::size_t>(k));
+        std::partial_sort(out.begin(), out.begin() + keep, out.end(), byEnergy);
+        out.resize(keep);
+    }
+
+    // Parte repetidamente el rectángulo de mayor energía en su mejor corte hasta tener p.
+    std::vector<Rect> greedySplit(const Rect &full, int p, const ZoneCost &cost)
+    {
+        std::vector<Rect> rects{full};
+        std::vector<double> energies{cost(full)};
+        rects.reserve(p);
+        energies.reserve(p);
+        std::vector<Cut> cuts;
+        while (static_cast<int>(rects.size()) < p)
+        {
+            int idx = -1;
+            for (int i = 0; i < static_cast<int>(rects.size()); ++i)
+            {
+                if (rects[i].area() >= 2 && (idx < 0 || energies[i] > energies[idx]))
+                {
+                    idx = i;
+                }
+            }
+            if (idx < 0)
+            {
+                break; // no se puede seguir dividiendo
+            }
+            bestCuts(rects[idx], cost, 1, cuts);
+            rects[idx] = cuts[0].first;
+            energies[idx] = cuts[0].firstEnergy;
+            rects.push_back(cuts[0].second);
+            energies.push_back(cuts[0].secondEnergy);
+        }
+        return rects;
+    }
+
+    struct BeamState
+    {
+        std::vector<Rect> rects;
+        std::vector<double> energies;
+        double total = 0.0;
+    };
+
+    // Misma partición con otro orden de cortes: se compara la lista ordenada por esquina.
+    std::vector<Rect> canonical(std::vector<Rect> rects)
+    {
+        std::sort(rects.begin(), rects.end(), [](const Rect &a, const Rect &b)
+                  { return std::tie(a.top, a.left) < std::tie(b.top, b.left); });
+        return rects;
+    }
+
+    bool samePartition(const std::vector<Rect> &a, const std::vector<Rect> &b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Rect &x, const Rect &y)
+                          { return x.top == y.top && x.bottom == y.bottom && x.left == y.left && x.right == y.right; });
+    }
+
+    std::vector<Rect> beamSplit(const Rect &full, int p, const ZoneCost &cost, int width, int cutsPerRect)
+    {
+        struct Candidate
+        {
+            double total;
+            int state;
+            int rect;
+            Cut cut;
+        };
+
+        std::vector<BeamState> beam(1);
+        beam[0].rects = {full};
+        beam[0].energies = {cost(full)};
+        beam[0].total = beam[0].energies[0];
+
+        std::vector<Cut> cuts;
+        std::vector<Candidate> candidates;
+        for (int zones = 1; zones < p; ++zones)
+        {
+            candidates.clear();
+            for (int s = 0; s < static_cast<int>(beam.size()); ++s)
+            {
+                const BeamState &state = beam[s];
+                for (int i = 0; i < static_cast<int>(state.rects.size()); ++i)
+                {
+                    if (state.rects[i].area() < 2)
+                    {
+                        continue;
+                    }
+                    bestCuts(state.rects[i], cost, cutsPerRect, cuts);
+                    for (const Cut &c : cuts)
+                    {
+                        candidates.push_back(Candidate{state.total - state.energies[i] + c.energy(), s, i, c});
+                    }
+                }
+            }
+            if (candidates.empty())
+            {
+                break; // no se puede seguir dividiendo
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+                             { return a.total < b.total; });
+
+            std::vector<BeamState> next;
+            std::vector<std::vector<Rect>> seen;
+            for (const Candidate &c : candidates)
+            {
+                if (static_cast<int>(next.size()) == width)
+                {
+                    break;
+                }
+                BeamState child = beam[c.state];
+                child.rects[c.rect] = c.cut.first;
+                child.energies[c.rect] = c.cut.firstEnergy;
+                child.rects.push_back(c.cut.second);
+                child.energies.push_back(c.cut.secondEnergy);
+                child.total = c.total;
+
+                std::vector<Rect> key = canonical(child.rects);
+                if (std::any_of(seen.begin(), seen.end(), [&](const std::vector<Rect> &k)
+                                { return samePartition(k, key); }))
+                {
+                    continue;
+                }
+                seen.push_back(std::move(key));
+                next.push_back(std::move(child));
+            }
+            beam = std::move(next);
+        }
+        return beam.front().rects;
+    }
+
+    // k-means 1D: con los valores ordenados cada grupo es un tramo contiguo delimitado por
+    // los puntos medios entre centros, así que una iteración de Lloyd cuesta O(k log n).
+    // Devuelve la grilla con cada celda reemplazada por el centro de su grupo.
+    Grid<double> quantizeByKMeans(const ProblemInstance &instance, int k, Rng &rng)
+    {
+        std::vector<double> values;
+        values.reserve(static_cast<std::size_t>(instance.nRows) * instance.nCols);
+        for (int i = 0; i < instance.nRows; ++i)
+        {
+            values.insert(values.end(), instance.S[i], instance.S[i] + instance.nCols);
+        }
+        std::sort(values.begin(), values.end());
+        const std::size_t n = values.size();
+        std::vector<double> prefix(n + 1, 0.0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            prefix[i + 1] = prefix[i] + values[i];
+        }
+
+        // Centros iniciales: un valor al azar dentro de cada franja de cuantiles.
+        std::uniform_real_distribution<double> uniform01(0.0, 1.0);
+        std::vector<double> centers(k);
+        for (int j = 0; j < k; ++j)
+        {
+            const std::size_t idx = static_cast<std::size_t>((j + uniform01(rng)) * static_cast<double>(n) / k);
+            centers[j] = values[std::min(idx, n - 1)];
+        }
+        std::sort(centers.begin(), centers.end());
+
+        std::vector<std::size_t> ends(k);
+        for (int iter = 0; iter < 100; ++iter)
+        {
+            for (int j = 0; j + 1 < k; ++j)
+            {
+                const double boundary = 0.5 * (centers[j] + centers[j + 1]);
+                ends[j] = std::lower_bound(values.begin(), values.end(), boundary) - values.begin();
+            }
+            ends[k - 1] = n;
+
+            bool changed = false;
+            std::size_t begin = 0;
+            for (int j = 0; j < k; ++j)
+            {
+                if (ends[j] > begin) // un grupo vacío conserva su centro
+                {
+                    const double mean = (prefix[ends[j]] - prefix[begin]) / static_cast<double>(ends[j] - begin);
+                    changed = changed || mean != centers[j];
+                    centers[j] = mean;
+                }
+                begin = std::max(begin, ends[j]);
+            }
+            if (!changed)
+            {
+                break;
+            }
+        }
+
+        Grid<double> quantized(instance.nRows, instance.nCols);
+        std::vector<double> boundaries(k > 1 ? k - 1 : 0);
+        for (int j = 0; j + 1 < k; ++j)
+        {
+            boundaries[j] = 0.5 * (centers[j] + centers[j + 1]);
+        }
+        for (int i = 0; i < instance.nRows; ++i)
+        {
+            for (int j = 0; j < instance.nCols; ++j)
+            {
+                const std::size_t group = std::lower_bound(boundaries.begin(), boundaries.end(), instance.S[i][j]) - boundaries.begin();
+                quantized[i][j] = centers[group];
+            }
+        }
+        return quantized;
+    }
+}
+
+Solution buildSeededSolution(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg, Rng &rng)
+{
+    if (cfg.seeding == "random")
+    {
+        return buildInitialSolution(instance, rng);
+    }
+    if (cfg.seeding == "dp")
+    {
+        SAConfig dpCfg = cfg;
+        dpCfg.threads = 1; // ya se ejecuta dentro del hilo de una cadena (los drivers usan buildSharedSeed)
+        return guillotineDP(instance, dpCfg);
+    }
+
+    const Rect full{0, instance.nRows - 1, 0, instance.nCols - 1};
+    const ZoneCost cost(integral, instance.alpha * totalVariance, cfg.penaltyWeight);
+    Solution sol;
+    if (cfg.seeding == "variance")
+    {
+        sol.rects = greedySplit(full, instance.p, cost);
+    }
+    else if (cfg.seeding == "beam")
+    {
+        sol.rects = beamSplit(full, instance.p, cost, std::max(1, cfg.seedBeamWidth), std::max(1, cfg.seedBeamCuts));
+    }
+    else if (cfg.seeding == "kmeans")
+    {
+        const long long cells = static_cast<long long>(instance.nRows) * instance.nCols;
+        const int k = static_cast<int>(std::max(1LL, std::min<long long>(instance.p, cells)));
+        ProblemInstance quantized;
+        quantized.nRows = instance.nRows;
+        quantized.nCols = instance.nCols;
+        quantized.S = quantizeByKMeans(instance, k, rng);
+        const IntegralImage quantizedIntegral(quantized);
+        // Solo SSE: sobre la grilla cuantizada los cortes de menor SSE caen en bordes entre grupos.
+        sol.rects = greedySplit(full, instance.p, ZoneCost(quantizedIntegral, 0.0, 0.0));
+    }
+    else
+    {
+        throw std::runtime_error("Estrategia de partida desconocida: " + cfg.seeding);
+    }
+
+    std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
+    std::vector<int> counts(instance.p + 1, 0);
+    sol.errorTotal = calculateErrorAndVariance(instance, integral, sol.rects, means, variances, counts);
+    return sol;
+}
+
+bool isSharedSeeding(const SAConfig &cfg)
+{
+    return cfg.seeding == "variance" || cfg.seeding == "beam" || cfg.seeding == "dp";
+}
+
+Solution buildSharedSeed(const ProblemInstance &instance, const IntegralImage &integral, double totalVariance, const SAConfig &cfg)
+{
+    if (cfg.seeding == "dp")
+    {
+        return guillotineDP(instance, cfg);
+    }
+    Rng unused; // "variance" y "beam" no consumen el generador
+    return buildSeededSolution(instance, integral, totalVariance, cfg, unused);
+}
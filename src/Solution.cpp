@@ -4,11 +4,12 @@
 #include <cmath>
 #include <queue>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include "ZoneKernels.hpp"
 
 namespace
 {
-    using Grid = std::vector<std::vector<int>>;
-
     struct Bounds
     {
         int top = 0;
@@ -18,15 +19,16 @@ namespace
         bool initialized = false;
     };
 
-    std::vector<Bounds> computeZoneBounds(const Grid &Z, int p)
+    std::vector<Bounds> computeZoneBounds(const Grid<int> &Z, int p)
     {
         std::vector<Bounds> bounds(p + 1);
 
-        for (int i = 0; i < static_cast<int>(Z.size()); ++i)
+        for (int i = 0; i < Z.rows(); ++i)
         {
-            for (int j = 0; j < static_cast<int>(Z[0].size()); ++j)
+            const int *row = Z[i];
+            for (int j = 0; j < Z.cols(); ++j)
             {
-                int zone = Z[i][j];
+                int zone = row[j];
                 auto &b = bounds[zone];
                 if (!b.initialized)
                 {
@@ -47,26 +49,124 @@ namespace
         return bounds;
     }
 
+#ifdef SPP_DEBUG_CHECKS
+    // Versiones escalares celda a celda, usadas como referencia para validar los núcleos SIMD.
+    double errorAndVarianceScalar(const ProblemInstance &instance, const Grid<int> &Z)
+    {
+        std::vector<double> means(instance.p + 1, 0.0);
+        std::vector<int> counts(instance.p + 1, 0);
+        for (int i = 0; i < instance.nRows; ++i)
+        {
+            for (int j = 0; j < instance.nCols; ++j)
+            {
+                means[Z[i][j]] += instance.S[i][j];
+                counts[Z[i][j]] += 1;
+            }
+        }
+        for (int k = 1; k <= instance.p; ++k)
+        {
+            if (counts[k] > 0)
+            {
+                means[k] /= static_cast<double>(counts[k]);
+            }
+        }
+
+        double errorTotal = 0.0;
+        for (int i = 0; i < instance.nRows; ++i)
+        {
+            for (int j = 0; j < instance.nCols; ++j)
+            {
+                double diff = instance.S[i][j] - means[Z[i][j]];
+                errorTotal += diff * diff;
+            }
+        }
+        return errorTotal;
+    }
+
+    double totalVarianceScalar(const ProblemInstance &instance)
+    {
+        double sum = 0.0;
+        double sumSq = 0.0;
+        for (int i = 0; i < instance.nRows; ++i)
+        {
+            for (int j = 0; j < instance.nCols; ++j)
+            {
+                sum += instance.S[i][j];
+                sumSq += instance.S[i][j] * instance.S[i][j];
+            }
+        }
+        const double total = static_cast<double>(instance.nRows) * instance.nCols;
+        const double mean = sum / total;
+        return sumSq / total - mean * mean;
+    }
+
+    // El orden de las sumas cambia entre núcleos, así que se compara con tolerancia relativa.
+    bool closeEnough(double a, double b)
+    {
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+    }
+#endif
+
+    // Primera celda (índice lineal i * nCols + j) de cada zona 1..p, o -1 si la zona está vacía.
+    // Un solo recorrido en vez de buscar la semilla del BFS desde (0,0) para cada zona.
+    std::vector<long long> firstCellOfZones(const Grid<int> &Z, int p)
+    {
+        std::vector<long long> first(p + 1, -1);
+        int pending = p;
+        for (int i = 0; i < Z.rows() && pending > 0; ++i)
+        {
+            const int *row = Z[i];
+            for (int j = 0; j < Z.cols(); ++j)
+            {
+                const int zone = row[j];
+                if (zone >= 1 && zone <= p && first[zone] < 0)
+                {
+                    first[zone] = static_cast<long long>(i) * Z.cols() + j;
+                    --pending;
+                }
+            }
+        }
+        return first;
+    }
+
+    // ¿El rectángulo o toca el lado 'dir' de b? (0: superior, 1: inferior, 2: izquierdo, 3: derecho)
+    bool touchesSide(const Rect &b, const Rect &o, int dir)
+    {
+        switch (dir)
+        {
+        case 0:
+            return o.bottom == b.top - 1 && o.right >= b.left && o.left <= b.right;
+        case 1:
+            return o.top == b.bottom + 1 && o.right >= b.left && o.left <= b.right;
+        case 2:
+            return o.right == b.left - 1 && o.bottom >= b.top && o.top <= b.bottom;
+        default:
+            return o.left == b.right + 1 && o.bottom >= b.top && o.top <= b.bottom;
+        }
+    }
+
+    // ¿b y o comparten el lado 'dir' de b completo?
+    bool sharesFullSide(const Rect &b, const Rect &o, int dir)
+    {
+        if (dir <= 1)
+        {
+            return o.left == b.left && o.right == b.right;
+        }
+        return o.top == b.top && o.bottom == b.bottom;
+    }
+
 }
 
 Solution buildInitialSolution(const ProblemInstance &instance)
 {
-    Solution sol;
-    sol.Z.assign(instance.nRows, std::vector<int>(instance.nCols, 1));
-
-    struct Rect
-    {
-        int top;
-        int bottom;
-        int left;
-        int right;
+    Rng rng(randomSeed());
+    return buildInitialSolution(instance, rng);
+}
 
-        int height() const { return bottom - top + 1; }
-        int width() const { return right - left + 1; }
-        int area() const { return height() * width(); }
-    };
+Solution buildInitialSolution(const ProblemInstance &instance, Rng &rng)
+{
+    Solution sol;
 
-    std::mt19937 rng(std::random_device{}());
     std::uniform_real_distribution<double> uniform01(0.0, 1.0);
 
     std::vector<Rect> rects;
@@ -129,26 +229,30 @@ Solution buildInitialSolution(const ProblemInstance &instance)
         rects.pop_back();
     }
 
+    sol.rects = std::move(rects);
+
+    std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
+    std::vector<int> counts(instance.p + 1, 0);
+    sol.errorTotal = calculateErrorAndVariance(instance, buildLabelGrid(instance, sol.rects), means, variances, counts);
+    return sol;
+}
+
+Grid<int> buildLabelGrid(const ProblemInstance &instance, const std::vector<Rect> &rects)
+{
+    Grid<int> Z(instance.nRows, instance.nCols, 1);
     for (int zoneId = 1; zoneId <= static_cast<int>(rects.size()); ++zoneId)
     {
         const Rect &r = rects[zoneId - 1];
         for (int i = r.top; i <= r.bottom; ++i)
         {
-            for (int j = r.left; j <= r.right; ++j)
-            {
-                sol.Z[i][j] = zoneId;
-            }
+            std::fill(Z[i] + r.left, Z[i] + r.right + 1, zoneId);
         }
     }
-
-    std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
-    std::vector<int> counts(instance.p + 1, 0);
-    sol.errorTotal = calculateErrorAndVariance(instance, sol.Z, means, variances, counts);
-    return sol;
+    return Z;
 }
 
 double calculateErrorAndVariance(const ProblemInstance &instance,
-                                 const std::vector<std::vector<int>> &Z,
+                                 const Grid<int> &Z,
                                  std::vector<double> &means,
                                  std::vector<double> &variances,
                                  std::vector<int> &counts)
@@ -158,15 +262,9 @@ double calculateErrorAndVariance(const ProblemInstance &instance,
     variances.assign(p + 1, 0.0);
     counts.assign(p + 1, 0);
 
-    for (int i = 0; i < instance.nRows; ++i)
-    {
-        for (int j = 0; j < instance.nCols; ++j)
-        {
-            int k = Z[i][j];
-            means[k] += instance.S[i][j];
-            counts[k] += 1;
-        }
-    }
+    // Dos pasadas (medias y luego desvíos) como en la versión escalar, pero por tramos
+    // de etiqueta constante con los núcleos SIMD (ver ZoneKernels).
+    ZoneKernels::accumulateZoneSums(instance.S, Z, means.data(), counts.data());
 
     for (int k = 1; k <= p; ++k)
     {
@@ -176,27 +274,54 @@ double calculateErrorAndVariance(const ProblemInstance &instance,
         }
     }
 
-    double errorTotal = 0.0;
-
-    for (int i = 0; i < instance.nRows; ++i)
-    {
-        for (int j = 0; j < instance.nCols; ++j)
-        {
-            int k = Z[i][j];
-            double diff = instance.S[i][j] - means[k];
-            variances[k] += diff * diff;
-            errorTotal += diff * diff;
-        }
-    }
+    ZoneKernels::accumulateZoneDeviations(instance.S, Z, means.data(), variances.data());
 
+    double errorTotal = 0.0;
     for (int k = 1; k <= p; ++k)
     {
+        errorTotal += variances[k];
         if (counts[k] > 0)
         {
             variances[k] /= static_cast<double>(counts[k]);
         }
     }
 
+#ifdef SPP_DEBUG_CHECKS
+    const double reference = errorAndVarianceScalar(instance, Z);
+    if (!closeEnough(errorTotal, reference))
+    {
+        throw std::runtime_error("calculateErrorAndVariance: el núcleo " + std::string(ZoneKernels::activeIsa()) +
+                                 " difiere de la versión escalar");
+    }
+#endif
+
+    return errorTotal;
+}
+
+double calculateErrorAndVariance(const ProblemInstance &instance,
+                                 const IntegralImage &integral,
+                                 const std::vector<Rect> &rects,
+                                 std::vector<double> &means,
+                                 std::vector<double> &variances,
+                                 std::vector<int> &counts)
+{
+    const int p = instance.p;
+    means.assign(p + 1, 0.0);
+    variances.assign(p + 1, 0.0);
+    counts.assign(p + 1, 0);
+
+    // Cada zona k es el rectángulo rects[k - 1]: sus estadísticas salen de la tabla en O(1).
+    double errorTotal = 0.0;
+    for (int k = 1; k <= p && k <= static_cast<int>(rects.size()); ++k)
+    {
+        const Rect &r = rects[k - 1];
+        const double sse = integral.sse(r);
+        counts[k] = integral.count(r);
+        means[k] = integral.mean(r);
+        variances[k] = sse / static_cast<double>(counts[k]);
+        errorTotal += sse;
+    }
+
     return errorTotal;
 }
 
@@ -206,17 +331,20 @@ double calculateTotalVariance(const ProblemInstance &instance)
     double sumSq = 0.0;
     int total = instance.nRows * instance.nCols;
 
-    for (const auto &row : instance.S)
-    {
-        for (double val : row)
-        {
-            sum += val;
-            sumSq += val * val;
-        }
-    }
+    ZoneKernels::gridSumAndSquares(instance.S, sum, sumSq);
 
     double mean = sum / static_cast<double>(total);
     double variance = (sumSq / static_cast<double>(total)) - mean * mean;
+
+#ifdef SPP_DEBUG_CHECKS
+    const double reference = totalVarianceScalar(instance);
+    if (!closeEnough(variance, reference))
+    {
+        throw std::runtime_error("calculateTotalVariance: el núcleo " + std::string(ZoneKernels::activeIsa()) +
+                                 " difiere de la versión escalar");
+    }
+#endif
+
     return variance;
 }
 
@@ -244,7 +372,7 @@ double calculateVariancePenalty(const ProblemInstance &instance,
 }
 
 bool isSolutionValid(const ProblemInstance &instance,
-                     const std::vector<std::vector<int>> &Z,
+                     const Grid<int> &Z,
                      double totalVariance)
 {
     std::vector<double> means(instance.p + 1, 0.0), variances(instance.p + 1, 0.0);
@@ -254,7 +382,8 @@ bool isSolutionValid(const ProblemInstance &instance,
     // Chequear que cada zona es conexa (4-neighbors) y respeta la varianza máxima.
     const int nRows = instance.nRows;
     const int nCols = instance.nCols;
-    std::vector<std::vector<bool>> visited(nRows, std::vector<bool>(nCols, false));
+    Grid<unsigned char> visited(nRows, nCols, 0);
+    const std::vector<long long> firstCell = firstCellOfZones(Z, instance.p);
 
     for (int k = 1; k <= instance.p; ++k)
     {
@@ -268,23 +397,12 @@ bool isSolutionValid(const ProblemInstance &instance,
         }
 
         // BFS para verificar conexidad de la zona k.
-        int startR = -1, startC = -1;
-        for (int i = 0; i < nRows && startR == -1; ++i)
-        {
-            for (int j = 0; j < nCols; ++j)
-            {
-                if (Z[i][j] == k)
-                {
-                    startR = i;
-                    startC = j;
-                    break;
-                }
-            }
-        }
-        if (startR == -1)
+        if (firstCell[k] < 0)
         {
             return false;
         }
+        const int startR = static_cast<int>(firstCell[k] / nCols);
+        const int startC = static_cast<int>(firstCell[k] % nCols);
 
         int visitedCount = 0;
         std::queue<std::pair<int, int>> q;
@@ -324,14 +442,124 @@ bool isSolutionValid(const ProblemInstance &instance,
     return true;
 }
 
+bool isSolutionValid(const ProblemInstance &instance,
+                     const IntegralImage &integral,
+                     const std::vector<Rect> &rects,
+                     double totalVariance)
+{
+    if (!isPartitionConnected(instance, rects))
+    {
+        return false;
+    }
+    for (const Rect &r : rects)
+    {
+        if (integral.variance(r) > instance.alpha * totalVariance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isPartitionConnected(const ProblemInstance &instance,
+                          const std::vector<Rect> &rects)
+{
+    std::vector<unsigned long long> corners;
+    return isPartitionConnected(instance, rects, corners);
+}
+
+bool isPartitionConnected(const ProblemInstance &instance,
+                          const std::vector<Rect> &rects,
+                          std::vector<unsigned long long> &corners)
+{
+    if (static_cast<int>(rects.size()) != instance.p)
+    {
+        return false;
+    }
+
+    // Teorema del mosaico perfecto: rectángulos dentro de la grilla cuya área suma N*M la
+    // cubren sin solapes si y solo si cada vértice aparece un número par de veces, salvo las
+    // cuatro esquinas de la grilla (exactamente una vez). Ordenar los 4p vértices cuesta O(p log p).
+    const unsigned long long vertexCols = static_cast<unsigned long long>(instance.nCols) + 1;
+    auto vertex = [vertexCols](int row, int col)
+    {
+        return static_cast<unsigned long long>(row) * vertexCols + static_cast<unsigned long long>(col);
+    };
+
+    corners.clear();
+    long long area = 0;
+    for (const Rect &r : rects)
+    {
+        if (r.top < 0 || r.left < 0 || r.bottom >= instance.nRows || r.right >= instance.nCols || r.top > r.bottom || r.left > r.right)
+        {
+            return false;
+        }
+        area += r.area();
+        corners.push_back(vertex(r.top, r.left));
+        corners.push_back(vertex(r.top, r.right + 1));
+        corners.push_back(vertex(r.bottom + 1, r.left));
+        corners.push_back(vertex(r.bottom + 1, r.right + 1));
+    }
+    if (area != static_cast<long long>(instance.nRows) * instance.nCols)
+    {
+        return false;
+    }
+
+    std::sort(corners.begin(), corners.end());
+    const unsigned long long gridCorners[4] = {vertex(0, 0), vertex(0, instance.nCols),
+                                               vertex(instance.nRows, 0), vertex(instance.nRows, instance.nCols)};
+    int oddCount = 0;
+    for (size_t i = 0; i < corners.size();)
+    {
+        size_t j = i + 1;
+        while (j < corners.size() && corners[j] == corners[i])
+        {
+            ++j;
+        }
+        if ((j - i) % 2 == 1)
+        {
+            // Solo las esquinas de la grilla pueden quedar sin pareja (y en orden creciente).
+            if (oddCount == 4 || corners[i] != gridCorners[oddCount])
+            {
+                return false;
+            }
+            ++oddCount;
+        }
+        i = j;
+    }
+    const bool tiles = oddCount == 4;
+
+#ifdef SPP_DEBUG_CHECKS
+    // Contraste con el recorrido BFS sobre la matriz de etiquetas.
+    if (tiles)
+    {
+        const Grid<int> Z = buildLabelGrid(instance, rects);
+        std::vector<double> means, variances;
+        std::vector<int> counts;
+        calculateErrorAndVariance(instance, Z, means, variances, counts);
+        bool sameAreas = true;
+        for (int k = 1; k <= instance.p; ++k)
+        {
+            sameAreas = sameAreas && counts[k] == rects[k - 1].area();
+        }
+        if (!sameAreas || !isPartitionConnected(instance, Z))
+        {
+            throw std::runtime_error("isPartitionConnected: el chequeo por vértices no coincide con el BFS");
+        }
+    }
+#endif
+
+    return tiles;
+}
+
 bool isPartitionConnected(const ProblemInstance &instance,
-                          const std::vector<std::vector<int>> &Z)
+                          const Grid<int> &Z)
 {
     const int nRows = instance.nRows;
     const int nCols = instance.nCols;
 
     std::vector<int> counts(instance.p + 1, 0);
-    std::vector<std::vector<bool>> visited(nRows, std::vector<bool>(nCols, false));
+    Grid<unsigned char> visited(nRows, nCols, 0);
 
     for (int i = 0; i < nRows; ++i)
     {
@@ -348,6 +576,7 @@ bool isPartitionConnected(const ProblemInstance &instance,
 
     const int dr[4] = {-1, 1, 0, 0};
     const int dc[4] = {0, 0, -1, 1};
+    const std::vector<long long> firstCell = firstCellOfZones(Z, instance.p);
 
     for (int k = 1; k <= instance.p; ++k)
     {
@@ -355,23 +584,12 @@ bool isPartitionConnected(const ProblemInstance &instance,
         {
             return false;
         }
-        int startR = -1, startC = -1;
-        for (int i = 0; i < nRows && startR == -1; ++i)
-        {
-            for (int j = 0; j < nCols; ++j)
-            {
-                if (Z[i][j] == k)
-                {
-                    startR = i;
-                    startC = j;
-                    break;
-                }
-            }
-        }
-        if (startR == -1)
+        if (firstCell[k] < 0)
         {
             return false;
         }
+        const int startR = static_cast<int>(firstCell[k] / nCols);
+        const int startC = static_cast<int>(firstCell[k] % nCols);
 
         int visitedCount = 0;
         std::queue<std::pair<int, int>> q;
@@ -413,7 +631,15 @@ bool isPartitionConnected(const ProblemInstance &instance,
 // Intenta reparar la partición forzando que cada zona sea exactamente su bounding box.
 // Solo funciona si los rectángulos no se solapan entre sí. Devuelve true si se pudo reparar.
 bool makeRectsIfNonOverlapping(const ProblemInstance &instance,
-                               std::vector<std::vector<int>> &Z)
+                               Grid<int> &Z)
+{
+    std::vector<Rect> rects;
+    return makeRectsIfNonOverlapping(instance, Z, rects);
+}
+
+bool makeRectsIfNonOverlapping(const ProblemInstance &instance,
+                               Grid<int> &Z,
+                               std::vector<Rect> &rects)
 {
     const auto bounds = computeZoneBounds(Z, instance.p);
     for (int k = 1; k <= instance.p; ++k)
@@ -440,9 +666,11 @@ bool makeRectsIfNonOverlapping(const ProblemInstance &instance,
     }
 
     // Sin solapes: podemos rellenar cada rectángulo
+    rects.resize(instance.p);
     for (int k = 1; k <= instance.p; ++k)
     {
         const auto &b = bounds[k];
+        rects[k - 1] = Rect{b.top, b.bottom, b.left, b.right};
         for (int r = b.top; r <= b.bottom; ++r)
         {
             for (int c = b.left; c <= b.right; ++c)
@@ -455,9 +683,19 @@ bool makeRectsIfNonOverlapping(const ProblemInstance &instance,
 }
 
 bool generateNeighbor(const ProblemInstance &instance,
-                      const std::vector<std::vector<int>> &currentZ,
-                      std::vector<std::vector<int>> &neighborZ,
-                      std::mt19937 &rng)
+                      const Grid<int> &currentZ,
+                      Grid<int> &neighborZ,
+                      Rng &rng)
+{
+    BorderMove move;
+    return generateNeighbor(instance, currentZ, neighborZ, rng, move);
+}
+
+bool generateNeighbor(const ProblemInstance &instance,
+                      const Grid<int> &currentZ,
+                      Grid<int> &neighborZ,
+                      Rng &rng,
+                      BorderMove &move)
 {
     const int nRows = instance.nRows;
     const int nCols = instance.nCols;
@@ -527,6 +765,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[targetRow][c] = zone;
                 }
+                move = BorderMove{adj, zone, Rect{targetRow, targetRow, c1, c2}};
                 success = true;
             }
             else
@@ -566,6 +805,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[b.top][c] = adj;
                 }
+                move = BorderMove{zone, adj, Rect{b.top, b.top, c1, c2}};
                 success = true;
             }
         }
@@ -608,6 +848,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[targetRow][c] = zone;
                 }
+                move = BorderMove{adj, zone, Rect{targetRow, targetRow, c1, c2}};
                 success = true;
             }
             else
@@ -647,6 +888,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[b.bottom][c] = adj;
                 }
+                move = BorderMove{zone, adj, Rect{b.bottom, b.bottom, c1, c2}};
                 success = true;
             }
         }
@@ -689,6 +931,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[r][targetCol] = zone;
                 }
+                move = BorderMove{adj, zone, Rect{r1, r2, targetCol, targetCol}};
                 success = true;
             }
             else
@@ -728,6 +971,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[r][b.left] = adj;
                 }
+                move = BorderMove{zone, adj, Rect{r1, r2, b.left, b.left}};
                 success = true;
             }
         }
@@ -770,6 +1014,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[r][targetCol] = zone;
                 }
+                move = BorderMove{adj, zone, Rect{r1, r2, targetCol, targetCol}};
                 success = true;
             }
             else
@@ -809,6 +1054,7 @@ bool generateNeighbor(const ProblemInstance &instance,
                 {
                     neighborZ[r][b.right] = adj;
                 }
+                move = BorderMove{zone, adj, Rect{r1, r2, b.right, b.right}};
                 success = true;
             }
         }
@@ -821,3 +1067,130 @@ bool generateNeighbor(const ProblemInstance &instance,
 
     return false;
 }
+
+namespace
+{
+    // Elige un movimiento de borde entre dos zonas que comparten el lado completo.
+    // No modifica 'current'; devuelve los nuevos rectángulos de ambas zonas y la franja transferida.
+    bool pickBorderMove(const std::vector<Rect> &current, Rng &rng, RectChange &zoneChange, RectChange &adjChange, BorderMove &border)
+    {
+        const int p = static_cast<int>(current.size());
+        if (p < 2)
+        {
+            return false;
+        }
+
+        std::uniform_int_distribution<int> zoneDist(1, p);
+        std::uniform_int_distribution<int> dirDist(0, 3);    // 0:top,1:bottom,2:left,3:right
+        std::uniform_int_distribution<int> expandDist(0, 1); // 1 expand, 0 shrink
+
+        for (int attempt = 0; attempt < 200; ++attempt)
+        {
+            int zone = zoneDist(rng);
+            const Rect &b = current[zone - 1];
+            int dir = dirDist(rng);
+            bool expand = expandDist(rng) == 1;
+
+            // Elegir al azar una zona vecina a través del borde (reservoir sampling, sin memoria extra).
+            int adj = 0;
+            int seen = 0;
+            for (int k = 1; k <= p; ++k)
+            {
+                if (k != zone && touchesSide(b, current[k - 1], dir))
+                {
+                    ++seen;
+                    if (std::uniform_int_distribution<int>(1, seen)(rng) == 1)
+                    {
+                        adj = k;
+                    }
+                }
+            }
+            if (adj == 0)
+            {
+                continue;
+            }
+
+            // Si el borde no es compartido por completo, alguna de las dos zonas deja de ser rectángulo.
+            const Rect &a = current[adj - 1];
+            if (!sharesFullSide(b, a, dir))
+            {
+                continue;
+            }
+            // La zona que cede la franja debe seguir teniendo al menos una fila/columna.
+            const Rect &giver = expand ? a : b;
+            if ((dir <= 1 ? giver.height() : giver.width()) < 2)
+            {
+                continue;
+            }
+
+            Rect nb = b;
+            Rect na = a;
+            Rect strip = b;
+            const int step = expand ? 1 : -1;
+            switch (dir)
+            {
+            case 0: // borde superior
+                strip.top = strip.bottom = expand ? b.top - 1 : b.top;
+                nb.top -= step;
+                na.bottom -= step;
+                break;
+            case 1: // borde inferior
+                strip.top = strip.bottom = expand ? b.bottom + 1 : b.bottom;
+                nb.bottom += step;
+                na.top += step;
+                break;
+            case 2: // borde izquierdo
+                strip.left = strip.right = expand ? b.left - 1 : b.left;
+                nb.left -= step;
+                na.right -= step;
+                break;
+            default: // borde derecho
+                strip.left = strip.right = expand ? b.right + 1 : b.right;
+                nb.right += step;
+                na.left += step;
+                break;
+            }
+
+            zoneChange = RectChange{zone, b, nb};
+            adjChange = RectChange{adj, a, na};
+            border = expand ? BorderMove{adj, zone, strip} : BorderMove{zone, adj, strip};
+            return true;
+        }
+
+        return false;
+    }
+}
+
+bool generateNeighbor(const ProblemInstance & /*instance*/,
+                      const std::vector<Rect> &current,
+                      std::vector<Rect> &neighbor,
+                      Rng &rng,
+                      BorderMove &move)
+{
+    RectChange zoneChange, adjChange;
+    if (!pickBorderMove(current, rng, zoneChange, adjChange, move))
+    {
+        return false;
+    }
+    neighbor = current;
+    neighbor[zoneChange.zone - 1] = zoneChange.after;
+    neighbor[adjChange.zone - 1] = adjChange.after;
+    return true;
+}
+
+bool proposeBorderMove(const ProblemInstance & /*instance*/,
+                       const std::vector<Rect> &current,
+                       Rng &rng,
+                       Move &move)
+{
+    RectChange zoneChange, adjChange;
+    BorderMove border;
+    move.clear();
+    if (!pickBorderMove(current, rng, zoneChange, adjChange, border))
+    {
+        return false;
+    }
+    move.changes.push_back(zoneChange);
+    move.changes.push_back(adjChange);
+    return true;
+}
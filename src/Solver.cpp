@@ -0,0 +1,22 @@
+#include "Solver.hpp"
+
+#include "IslandModel.hpp"
+#include "ParallelSA.hpp"
+#include "ParallelTempering.hpp"
+
+Solution solveInstance(const ProblemInstance &instance, const SAConfig &cfg, std::vector<SAStats> *chainStats, Solution *initialOut, DPStats *dpStats)
+{
+    if (cfg.mode == "dp")
+    {
+        return guillotineDP(instance, cfg, chainStats, initialOut, dpStats);
+    }
+    if (cfg.mode == "tempering")
+    {
+        return parallelTempering(instance, cfg, chainStats, initialOut);
+    }
+    if (cfg.mode == "islands")
+    {
+        return islandAnnealing(instance, cfg, chainStats, initialOut);
+    }
+    return parallelSimulatedAnnealing(instance, cfg, chainStats, initialOut);
+}
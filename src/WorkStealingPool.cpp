@@ -0,0 +1,135 @@
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Pool e índice del hilo actual (para que las tareas anidadas vayan a la cola propia).
+    thread_local const WorkStealingPool *currentPool = nullptr;
+    thread_local int currentWorker = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+    threads = std::max(1, threads);
+    for (int i = 0; i < threads; ++i)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workCv.notify_all();
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    int target = (currentPool == this) ? currentWorker : static_cast<int>(nextQueue++ % queues.size());
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    ++queued;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    workCv.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idleCv.wait(lock, [&] { return pending == 0; });
+    if (error)
+    {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+bool WorkStealingPool::popLocal(int self, Task &task)
+{
+    Queue &q = *queues[self];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    --queued;
+    return true;
+}
+
+bool WorkStealingPool::steal(int self, Task &task)
+{
+    const int n = static_cast<int>(queues.size());
+    for (int k = 1; k < n; ++k)
+    {
+        Queue &q = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty())
+        {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int self)
+{
+    currentPool = this;
+    currentWorker = self;
+
+    while (true)
+    {
+        Task task;
+        if (popLocal(self, task) || steal(self, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            if (--pending == 0)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idleCv.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        workCv.wait(lock, [&] { return queued > 0 || stopping; });
+        if (stopping && queued == 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,275 @@
+#include "ZoneAdjacency.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+    // Capacidad inicial de cada lista de vecinas: una zona puede llegar a p - 1 vecinas en un
+    // lado y, si la lista creciera durante SA, update() reservaría memoria en pleno bucle.
+    // Con p <= kReservedNeighbors + 1 ninguna lista vuelve a crecer; con p mayor se acota la
+    // memoria (4 * p * kReservedNeighbors vecinas) y superar el tope en un lado es excepcional.
+    constexpr int kReservedNeighbors = 64;
+
+    // ¿'o' toca el lado 'side' de 'b'? Si es así, devuelve en [from, to] el tramo compartido.
+    bool touches(const Rect &b, const Rect &o, int side, int &from, int &to)
+    {
+        bool adjacent = false;
+        switch (side)
+        {
+        case 0:
+            adjacent = o.bottom == b.top - 1;
+            break;
+        case 1:
+            adjacent = o.top == b.bottom + 1;
+            break;
+        case 2:
+            adjacent = o.right == b.left - 1;
+            break;
+        default:
+            adjacent = o.left == b.right + 1;
+            break;
+        }
+        if (!adjacent)
+        {
+            return false;
+        }
+        from = side <= 1 ? std::max(b.left, o.left) : std::max(b.top, o.top);
+        to = side <= 1 ? std::min(b.right, o.right) : std::min(b.bottom, o.bottom);
+        return from <= to;
+    }
+
+    // Filas (lados superior/inferior) o columnas (laterales) que puede ceder la zona.
+    int thickness(const Rect &r, int side)
+    {
+        return side <= 1 ? r.height() : r.width();
+    }
+}
+
+void ZoneAdjacency::reset(const std::vector<Rect> &rects)
+{
+    const int p = static_cast<int>(rects.size());
+    sides.assign(p + 1, {});
+    const int reserved = std::max(1, std::min(p - 1, kReservedNeighbors));
+    for (auto &zoneSides : sides)
+    {
+        for (auto &list : zoneSides)
+        {
+            list.reserve(reserved);
+        }
+    }
+    moves.clear();
+    moves.reserve(4 * static_cast<size_t>(p)); // a lo sumo 2p pares con lado completo, dos movimientos cada uno
+    changedStamp.assign(p + 1, 0);
+    candidateStamp.assign(p + 1, 0);
+    candidates.clear();
+    candidates.reserve(p);
+
+    // En la reconstrucción todas las zonas cuentan como modificadas.
+    epoch = 1;
+    std::fill(changedStamp.begin(), changedStamp.end(), epoch);
+
+    for (int z = 1; z <= p; ++z)
+    {
+        for (int c = z + 1; c <= p; ++c)
+        {
+            link(rects, z, c, true);
+        }
+    }
+    for (int z = 1; z <= p; ++z)
+    {
+        addMovesOf(rects, z);
+    }
+}
+
+void ZoneAdjacency::link(const std::vector<Rect> &rects, int zone, int other, bool mirror)
+{
+    const Rect &b = rects[zone - 1];
+    const Rect &o = rects[other - 1];
+    for (int side = 0; side < 4; ++side)
+    {
+        int from = 0;
+        int to = 0;
+        if (touches(b, o, side, from, to))
+        {
+            sides[zone][side].push_back(Neighbor{other, from, to});
+            if (mirror)
+            {
+                sides[other][side ^ 1].push_back(Neighbor{zone, from, to});
+            }
+        }
+    }
+}
+
+void ZoneAdjacency::addMovesOf(const std::vector<Rect> &rects, int zone)
+{
+    const Rect &b = rects[zone - 1];
+    for (int side = 0; side < 4; ++side)
+    {
+        // Lado completo compartido: una única vecina que cubre exactamente el mismo tramo.
+        const auto &list = sides[zone][side];
+        if (list.size() != 1)
+        {
+            continue;
+        }
+        const int other = list[0].zone;
+        // Cada par se registra una sola vez: si ambas zonas cambiaron, lo hace la de menor índice.
+        if (changedStamp[other] == epoch && other < zone)
+        {
+            continue;
+        }
+        const Rect &o = rects[other - 1];
+        const bool fullSide = side <= 1 ? (o.left == b.left && o.right == b.right)
+                                        : (o.top == b.top && o.bottom == b.bottom);
+        if (!fullSide)
+        {
+            continue;
+        }
+        if (thickness(o, side) >= 2)
+        {
+            moves.push_back(EdgeMove{other, zone, side});
+        }
+        if (thickness(b, side) >= 2)
+        {
+            moves.push_back(EdgeMove{zone, other, side ^ 1});
+        }
+    }
+}
+
+void ZoneAdjacency::update(const std::vector<Rect> &rects, const Move &move)
+{
+    if (++epoch == 0)
+    {
+        std::fill(changedStamp.begin(), changedStamp.end(), 0);
+        std::fill(candidateStamp.begin(), candidateStamp.end(), 0);
+        epoch = 1;
+    }
+    candidates.clear();
+
+    // Zonas modificadas primero; luego sus vecinas previas (las únicas que pueden ganar o
+    // perder adyacencias con ellas).
+    for (const RectChange &c : move.changes)
+    {
+        if (candidateStamp[c.zone] != epoch)
+        {
+            candidateStamp[c.zone] = epoch;
+            changedStamp[c.zone] = epoch;
+            candidates.push_back(c.zone);
+        }
+    }
+    const size_t changedCount = candidates.size();
+    for (size_t i = 0; i < changedCount; ++i)
+    {
+        for (const auto &list : sides[candidates[i]])
+        {
+            for (const Neighbor &n : list)
+            {
+                if (candidateStamp[n.zone] != epoch)
+                {
+                    candidateStamp[n.zone] = epoch;
+                    candidates.push_back(n.zone);
+                }
+            }
+        }
+    }
+
+    auto isChanged = [this](int zone)
+    { return changedStamp[zone] == epoch; };
+
+    for (size_t i = changedCount; i < candidates.size(); ++i)
+    {
+        for (auto &list : sides[candidates[i]])
+        {
+            list.erase(std::remove_if(list.begin(), list.end(), [&](const Neighbor &n)
+                                      { return isChanged(n.zone); }),
+                       list.end());
+        }
+    }
+    for (size_t i = 0; i < changedCount; ++i)
+    {
+        for (auto &list : sides[candidates[i]])
+        {
+            list.clear();
+        }
+    }
+    for (size_t i = 0; i < changedCount; ++i)
+    {
+        for (int other : candidates)
+        {
+            if (other != candidates[i])
+            {
+                link(rects, candidates[i], other, !isChanged(other));
+            }
+        }
+    }
+
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [&](const EdgeMove &m)
+                               { return isChanged(m.giver) || isChanged(m.receiver); }),
+                moves.end());
+    for (size_t i = 0; i < changedCount; ++i)
+    {
+        addMovesOf(rects, candidates[i]);
+    }
+
+#ifdef SPP_DEBUG_CHECKS
+    // Contraste con una reconstrucción completa.
+    ZoneAdjacency fresh;
+    fresh.reset(rects);
+    auto key = [](const EdgeMove &m)
+    { return std::make_tuple(m.giver, m.receiver, m.side); };
+    auto byKey = [&](const EdgeMove &a, const EdgeMove &b)
+    { return key(a) < key(b); };
+    std::vector<EdgeMove> mine = moves;
+    std::vector<EdgeMove> expected = fresh.moves;
+    std::sort(mine.begin(), mine.end(), byKey);
+    std::sort(expected.begin(), expected.end(), byKey);
+    bool same = mine.size() == expected.size();
+    for (size_t i = 0; same && i < mine.size(); ++i)
+    {
+        same = key(mine[i]) == key(expected[i]);
+    }
+    if (!same)
+    {
+        throw std::runtime_error("ZoneAdjacency::update: el índice incremental no coincide con la reconstrucción");
+    }
+#endif
+}
+
+bool ZoneAdjacency::proposeBorderMove(const std::vector<Rect> &rects, Rng &rng, Move &move) const
+{
+    move.clear();
+    if (moves.empty())
+    {
+        return false;
+    }
+
+    const EdgeMove &m = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+    const Rect &receiver = rects[m.receiver - 1];
+    const Rect &giver = rects[m.giver - 1];
+    Rect nr = receiver;
+    Rect ng = giver;
+    switch (m.side)
+    {
+    case 0: // la receptora sube su borde superior
+        --nr.top;
+        --ng.bottom;
+        break;
+    case 1:
+        ++nr.bottom;
+        ++ng.top;
+        break;
+    case 2:
+        --nr.left;
+        --ng.right;
+        break;
+    default:
+        ++nr.right;
+        ++ng.left;
+        break;
+    }
+
+    move.changes.push_back(RectChange{m.receiver, receiver, nr});
+    move.changes.push_back(RectChange{m.giver, giver, ng});
+    return true;
+}
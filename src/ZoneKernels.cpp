@@ -0,0 +1,388 @@
+#include "ZoneKernels.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SPP_HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Operaciones básicas sobre un tramo contiguo; cada ISA aporta su versión.
+    struct KernelTable
+    {
+        const char *name;
+        // Primer índice >= start con z[j] != z[start] (o n si no hay).
+        std::size_t (*runEnd)(const int *z, std::size_t start, std::size_t n);
+        double (*sum)(const double *v, std::size_t n);
+        double (*sumSquaredDeviations)(const double *v, std::size_t n, double center);
+        void (*sumAndSquares)(const double *v, std::size_t n, double &sum, double &sumSq);
+    };
+
+    // ---------------------------------------------------------------- escalar
+
+    std::size_t runEndScalar(const int *z, std::size_t start, std::size_t n)
+    {
+        const int label = z[start];
+        std::size_t j = start + 1;
+        while (j < n && z[j] == label)
+        {
+            ++j;
+        }
+        return j;
+    }
+
+    double sumScalar(const double *v, std::size_t n)
+    {
+        double acc = 0.0;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            acc += v[j];
+        }
+        return acc;
+    }
+
+    double sumSquaredDeviationsScalar(const double *v, std::size_t n, double center)
+    {
+        double acc = 0.0;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const double d = v[j] - center;
+            acc += d * d;
+        }
+        return acc;
+    }
+
+    void sumAndSquaresScalar(const double *v, std::size_t n, double &sum, double &sumSq)
+    {
+        double s = 0.0;
+        double sq = 0.0;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            s += v[j];
+            sq += v[j] * v[j];
+        }
+        sum = s;
+        sumSq = sq;
+    }
+
+#ifdef SPP_HAVE_X86_KERNELS
+
+    // ---------------------------------------------------------------- AVX2
+    // Cuatro acumuladores independientes (16 doubles por vuelta) para ocultar la
+    // latencia de la suma; el resto del tramo se completa en escalar.
+
+    __attribute__((target("avx2"))) double horizontalSum256(__m256d v)
+    {
+        __m128d lo = _mm256_castpd256_pd128(v);
+        __m128d hi = _mm256_extractf128_pd(v, 1);
+        lo = _mm_add_pd(lo, hi);
+        return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    }
+
+    __attribute__((target("avx2"))) std::size_t runEndAvx2(const int *z, std::size_t start, std::size_t n)
+    {
+        const int label = z[start];
+        const __m256i ref = _mm256_set1_epi32(label);
+        std::size_t j = start + 1;
+        for (; j + 8 <= n; j += 8)
+        {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(z + j));
+            const int equal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, ref)));
+            if (equal != 0xFF)
+            {
+                return j + static_cast<std::size_t>(__builtin_ctz(~equal & 0xFF));
+            }
+        }
+        while (j < n && z[j] == label)
+        {
+            ++j;
+        }
+        return j;
+    }
+
+    __attribute__((target("avx2,fma"))) double sumAvx2(const double *v, std::size_t n)
+    {
+        __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+        std::size_t j = 0;
+        for (; j + 16 <= n; j += 16)
+        {
+            a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + j));
+            a1 = _mm256_add_pd(a1, _mm256_loadu_pd(v + j + 4));
+            a2 = _mm256_add_pd(a2, _mm256_loadu_pd(v + j + 8));
+            a3 = _mm256_add_pd(a3, _mm256_loadu_pd(v + j + 12));
+        }
+        for (; j + 4 <= n; j += 4)
+        {
+            a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + j));
+        }
+        double acc = horizontalSum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+        for (; j < n; ++j)
+        {
+            acc += v[j];
+        }
+        return acc;
+    }
+
+    __attribute__((target("avx2,fma"))) double sumSquaredDeviationsAvx2(const double *v, std::size_t n, double center)
+    {
+        const __m256d c = _mm256_set1_pd(center);
+        __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+        std::size_t j = 0;
+        for (; j + 16 <= n; j += 16)
+        {
+            const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(v + j), c);
+            const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(v + j + 4), c);
+            const __m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(v + j + 8), c);
+            const __m256d d3 = _mm256_sub_pd(_mm256_loadu_pd(v + j + 12), c);
+            a0 = _mm256_fmadd_pd(d0, d0, a0);
+            a1 = _mm256_fmadd_pd(d1, d1, a1);
+            a2 = _mm256_fmadd_pd(d2, d2, a2);
+            a3 = _mm256_fmadd_pd(d3, d3, a3);
+        }
+        for (; j + 4 <= n; j += 4)
+        {
+            const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(v + j), c);
+            a0 = _mm256_fmadd_pd(d, d, a0);
+        }
+        double acc = horizontalSum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+        for (; j < n; ++j)
+        {
+            const double d = v[j] - center;
+            acc += d * d;
+        }
+        return acc;
+    }
+
+    __attribute__((target("avx2,fma"))) void sumAndSquaresAvx2(const double *v, std::size_t n, double &sum, double &sumSq)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = s0, q0 = s0, q1 = s0;
+        std::size_t j = 0;
+        for (; j + 8 <= n; j += 8)
+        {
+            const __m256d x0 = _mm256_loadu_pd(v + j);
+            const __m256d x1 = _mm256_loadu_pd(v + j + 4);
+            s0 = _mm256_add_pd(s0, x0);
+            s1 = _mm256_add_pd(s1, x1);
+            q0 = _mm256_fmadd_pd(x0, x0, q0);
+            q1 = _mm256_fmadd_pd(x1, x1, q1);
+        }
+        double s = horizontalSum256(_mm256_add_pd(s0, s1));
+        double sq = horizontalSum256(_mm256_add_pd(q0, q1));
+        for (; j < n; ++j)
+        {
+            s += v[j];
+            sq += v[j] * v[j];
+        }
+        sum = s;
+        sumSq = sq;
+    }
+
+    // ---------------------------------------------------------------- AVX-512
+
+    __attribute__((target("avx512f"))) double horizontalSum512(__m512d v)
+    {
+        alignas(64) double lanes[8];
+        _mm512_store_pd(lanes, v);
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    __attribute__((target("avx512f"))) std::size_t runEndAvx512(const int *z, std::size_t start, std::size_t n)
+    {
+        const int label = z[start];
+        const __m512i ref = _mm512_set1_epi32(label);
+        std::size_t j = start + 1;
+        for (; j + 16 <= n; j += 16)
+        {
+            const __m512i block = _mm512_loadu_si512(z + j);
+            const __mmask16 differ = _mm512_cmpneq_epi32_mask(block, ref);
+            if (differ)
+            {
+                return j + static_cast<std::size_t>(__builtin_ctz(differ));
+            }
+        }
+        while (j < n && z[j] == label)
+        {
+            ++j;
+        }
+        return j;
+    }
+
+    __attribute__((target("avx512f"))) double sumAvx512(const double *v, std::size_t n)
+    {
+        __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+        std::size_t j = 0;
+        for (; j + 32 <= n; j += 32)
+        {
+            a0 = _mm512_add_pd(a0, _mm512_loadu_pd(v + j));
+            a1 = _mm512_add_pd(a1, _mm512_loadu_pd(v + j + 8));
+            a2 = _mm512_add_pd(a2, _mm512_loadu_pd(v + j + 16));
+            a3 = _mm512_add_pd(a3, _mm512_loadu_pd(v + j + 24));
+        }
+        for (; j + 8 <= n; j += 8)
+        {
+            a0 = _mm512_add_pd(a0, _mm512_loadu_pd(v + j));
+        }
+        if (j < n)
+        {
+            const __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+            a1 = _mm512_add_pd(a1, _mm512_maskz_loadu_pd(tail, v + j));
+        }
+        return horizontalSum512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+    }
+
+    __attribute__((target("avx512f"))) double sumSquaredDeviationsAvx512(const double *v, std::size_t n, double center)
+    {
+        const __m512d c = _mm512_set1_pd(center);
+        __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+        std::size_t j = 0;
+        for (; j + 32 <= n; j += 32)
+        {
+            const __m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(v + j), c);
+            const __m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(v + j + 8), c);
+            const __m512d d2 = _mm512_sub_pd(_mm512_loadu_pd(v + j + 16), c);
+            const __m512d d3 = _mm512_sub_pd(_mm512_loadu_pd(v + j + 24), c);
+            a0 = _mm512_fmadd_pd(d0, d0, a0);
+            a1 = _mm512_fmadd_pd(d1, d1, a1);
+            a2 = _mm512_fmadd_pd(d2, d2, a2);
+            a3 = _mm512_fmadd_pd(d3, d3, a3);
+        }
+        for (; j + 8 <= n; j += 8)
+        {
+            const __m512d d = _mm512_sub_pd(_mm512_loadu_pd(v + j), c);
+            a0 = _mm512_fmadd_pd(d, d, a0);
+        }
+        if (j < n)
+        {
+            // Las posiciones enmascaradas valen 0 y no deben aportar (0 - c)².
+            const __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+            const __m512d d = _mm512_maskz_sub_pd(tail, _mm512_maskz_loadu_pd(tail, v + j), c);
+            a1 = _mm512_fmadd_pd(d, d, a1);
+        }
+        return horizontalSum512(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+    }
+
+    __attribute__((target("avx512f"))) void sumAndSquaresAvx512(const double *v, std::size_t n, double &sum, double &sumSq)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = s0, q0 = s0, q1 = s0;
+        std::size_t j = 0;
+        for (; j + 16 <= n; j += 16)
+        {
+            const __m512d x0 = _mm512_loadu_pd(v + j);
+            const __m512d x1 = _mm512_loadu_pd(v + j + 8);
+            s0 = _mm512_add_pd(s0, x0);
+            s1 = _mm512_add_pd(s1, x1);
+            q0 = _mm512_fmadd_pd(x0, x0, q0);
+            q1 = _mm512_fmadd_pd(x1, x1, q1);
+        }
+        for (; j < n; j += 8)
+        {
+            const std::size_t left = n - j;
+            const __mmask8 mask = left >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << left) - 1);
+            const __m512d x = _mm512_maskz_loadu_pd(mask, v + j);
+            s0 = _mm512_add_pd(s0, x);
+            q0 = _mm512_fmadd_pd(x, x, q0);
+        }
+        sum = horizontalSum512(_mm512_add_pd(s0, s1));
+        sumSq = horizontalSum512(_mm512_add_pd(q0, q1));
+    }
+
+#endif // SPP_HAVE_X86_KERNELS
+
+    const KernelTable kScalarKernels = {"scalar", runEndScalar, sumScalar, sumSquaredDeviationsScalar, sumAndSquaresScalar};
+#ifdef SPP_HAVE_X86_KERNELS
+    const KernelTable kAvx2Kernels = {"avx2", runEndAvx2, sumAvx2, sumSquaredDeviationsAvx2, sumAndSquaresAvx2};
+    const KernelTable kAvx512Kernels = {"avx512", runEndAvx512, sumAvx512, sumSquaredDeviationsAvx512, sumAndSquaresAvx512};
+#endif
+
+    const KernelTable &selectKernels()
+    {
+#ifdef SPP_HAVE_X86_KERNELS
+        // SPP_SIMD solo puede bajar el nivel detectado, nunca pedir uno que la CPU no tiene.
+        const char *requested = std::getenv("SPP_SIMD");
+        const bool allowAvx512 = requested == nullptr || std::strcmp(requested, "avx512") == 0;
+        const bool allowAvx2 = allowAvx512 || std::strcmp(requested, "avx2") == 0;
+
+        __builtin_cpu_init();
+        if (allowAvx512 && __builtin_cpu_supports("avx512f"))
+        {
+            return kAvx512Kernels;
+        }
+        if (allowAvx2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return kAvx2Kernels;
+        }
+#endif
+        return kScalarKernels;
+    }
+
+    const KernelTable &kernels()
+    {
+        static const KernelTable &table = selectKernels();
+        return table;
+    }
+}
+
+namespace ZoneKernels
+{
+    const char *activeIsa()
+    {
+        return kernels().name;
+    }
+
+    void accumulateZoneSums(const Grid<double> &S, const Grid<int> &Z, double *sums, int *counts)
+    {
+        const KernelTable &k = kernels();
+        const std::size_t nCols = static_cast<std::size_t>(S.cols());
+        for (int i = 0; i < S.rows(); ++i)
+        {
+            const double *sRow = S[i];
+            const int *zRow = Z[i];
+            for (std::size_t j = 0; j < nCols;)
+            {
+                const std::size_t end = k.runEnd(zRow, j, nCols);
+                const int zone = zRow[j];
+                sums[zone] += k.sum(sRow + j, end - j);
+                counts[zone] += static_cast<int>(end - j);
+                j = end;
+            }
+        }
+    }
+
+    void accumulateZoneDeviations(const Grid<double> &S, const Grid<int> &Z, const double *means, double *sse)
+    {
+        const KernelTable &k = kernels();
+        const std::size_t nCols = static_cast<std::size_t>(S.cols());
+        for (int i = 0; i < S.rows(); ++i)
+        {
+            const double *sRow = S[i];
+            const int *zRow = Z[i];
+            for (std::size_t j = 0; j < nCols;)
+            {
+                const std::size_t end = k.runEnd(zRow, j, nCols);
+                const int zone = zRow[j];
+                sse[zone] += k.sumSquaredDeviations(sRow + j, end - j, means[zone]);
+                j = end;
+            }
+        }
+    }
+
+    void gridSumAndSquares(const Grid<double> &S, double &sum, double &sumSq)
+    {
+        const KernelTable &k = kernels();
+        const std::size_t nCols = static_cast<std::size_t>(S.cols());
+        sum = 0.0;
+        sumSq = 0.0;
+        for (int i = 0; i < S.rows(); ++i)
+        {
+            double rowSum = 0.0;
+            double rowSumSq = 0.0;
+            k.sumAndSquares(S[i], nCols, rowSum, rowSumSq);
+            sum += rowSum;
+            sumSq += rowSumSq;
+        }
+    }
+}
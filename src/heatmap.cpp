@@ -1,175 +1,387 @@
 #include "Heatmap.hpp"
 #include <opencv2/opencv.hpp>
 #include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 /**
  * Genera y visualiza un mapa de calor con delimitación opcional de zonas
- * 
+ *
  * Esta función crea una visualización de mapa de calor a partir de una matriz de datos numéricos,
- * con la capacidad de mostrar zonas delimitadas por rectángulos negros. La función utiliza 
+ * con la capacidad de mostrar zonas delimitadas por rectángulos negros. La función utiliza
  * interpolación cúbica para generar transiciones suaves entre los valores y permite diferentes
  * niveles de resolución.
- * 
- * @param M Matriz de datos de entrada (std::vector<std::vector<float>>)
+ *
+ * @param M Matriz de datos de entrada (Grid<float>)
  *          Contiene los valores numéricos que se representarán como colores en el mapa.
- *          Todos los vectores internos deben tener la misma longitud.
- * 
+ *
  * @param factor Factor de escala para la resolución de la imagen resultante (int)
  *               Valores recomendados: 10-30
  *               - Valores bajos (10-15): menor detalle, procesamiento más rápido
  *               - Valores altos (25-30): mayor detalle, procesamiento más lento
- * 
- * @param Z Matriz opcional de etiquetas de zonas (std::vector<std::vector<int>>, por defecto vacía)
+ *
+ * @param Z Matriz opcional de etiquetas de zonas (Grid<int>, por defecto vacía)
  *          Si se proporciona, debe tener las mismas dimensiones que M.
  *          Cada valor entero representa una zona diferente.
  *          Las zonas se delimitan automáticamente con rectángulos negros.
  *          Si se omite o está vacía, se muestra solo el mapa de calor sin delimitaciones.
- * 
+ *
  * @note Requisitos:
  *       - OpenCV debe estar instalado
  *       - La matriz M no puede estar vacía
  *       - Si se proporciona Z, debe tener las mismas dimensiones que M
- * 
+ *
  * @example Uso básico:
- * 
- *     std::vector<std::vector<float>> datos = {{1.0, 2.0}, {3.0, 4.0}};
+ *
+ *     Grid<float> datos(2, 2, 1.0f);
  *     plotHeatmap(datos, 20);  // Solo mapa de calor
- * 
+ *
  * @example Uso con zonas:
- * 
- *     std::vector<std::vector<float>> datos = {{1.0, 2.0}, {3.0, 4.0}};
- *     std::vector<std::vector<int>> zonas = {{1, 2}, {1, 2}};
+ *
+ *     Grid<float> datos(2, 2, 1.0f);
+ *     Grid<int> zonas(2, 2, 1);
+ *     zonas[0][1] = zonas[1][1] = 2;
  *     plotHeatmap(datos, 25, zonas);  // Mapa con delimitación de zonas
+ *
+ * La imagen se produce por franjas horizontales de HeatmapOptions::bandRows filas: cada
+ * franja escala solo las filas de M que necesita (más un margen de 2 filas para la
+ * interpolación cúbica), aplica el mapa de colores y dibuja los contornos de las zonas
+ * que la cruzan, que salen directamente de la lista de rectángulos. La memoria de trabajo
+ * es proporcional al ancho de la imagen por el alto de una franja, no a N·M·factor².
  */
 namespace
 {
-    cv::Mat buildHeatmapImage(const std::vector<std::vector<float>> &M, int factor, const std::vector<std::vector<int>> &Z)
-    {
-        if (M.empty() || M[0].empty()) {
-            throw std::invalid_argument("La matriz de datos no puede estar vacia.");
+    constexpr int kBorderExtension = 2; // marco blanco alrededor de la imagen
+    constexpr int kZoneMargin = 2;      // separación del contorno respecto del borde de la zona
+    constexpr int kCubicHalo = 2;       // filas vecinas que usa la interpolación cúbica
+
+    // Geometría de la imagen de salida. Con block == 1 cada celda ocupa factor x factor
+    // píxeles; con block > 1 (vista previa) cada píxel promedia un bloque de block x block celdas.
+    struct Layout {
+        int rows = 0;
+        int cols = 0;
+        int factor = 1;
+        int block = 1;
+        int outRows = 0; // sin el marco
+        int outCols = 0;
+        int margin = 0;
+
+        int height() const { return outRows + 2 * kBorderExtension; }
+        int width() const { return outCols + 2 * kBorderExtension; }
+
+        // Primera fila/columna de salida (sin marco) de la celda r/c; r == rows da outRows.
+        int rowEdge(int r) const { return block > 1 ? (r >= rows ? outRows : r / block) : r * factor; }
+        int colEdge(int c) const { return block > 1 ? (c >= cols ? outCols : c / block) : c * factor; }
+    };
+
+    Layout makeLayout(int rows, int cols, const HeatmapOptions &options) {
+        Layout layout;
+        layout.rows = rows;
+        layout.cols = cols;
+        layout.factor = std::max(1, options.factor);
+
+        const int maxDim = std::max(rows, cols);
+        if (options.maxOutputDim > 0 && static_cast<long long>(maxDim) * layout.factor > options.maxOutputDim) {
+            if (maxDim <= options.maxOutputDim) {
+                layout.factor = options.maxOutputDim / maxDim;
+            } else {
+                layout.factor = 1;
+                layout.block = (maxDim + options.maxOutputDim - 1) / options.maxOutputDim;
+            }
         }
 
-        const int rows = static_cast<int>(M.size());
-        const int cols = static_cast<int>(M[0].size());
+        layout.outRows = layout.block > 1 ? (rows + layout.block - 1) / layout.block : rows * layout.factor;
+        layout.outCols = layout.block > 1 ? (cols + layout.block - 1) / layout.block : cols * layout.factor;
+        // El contorno se separa del borde solo si las celdas son lo bastante grandes para verlo.
+        layout.margin = (layout.block == 1 && layout.factor > 2 * kZoneMargin) ? kZoneMargin : 0;
+        return layout;
+    }
 
-        for (const auto &row : M) {
-            if (static_cast<int>(row.size()) != cols) {
-                throw std::invalid_argument("Todas las filas de la matriz de datos deben tener la misma longitud.");
+    // Contorno de una zona en coordenadas de la imagen con marco (índices inclusivos). Las
+    // zonas que tocan el borde de la grilla se extienden hasta el borde exterior del marco.
+    struct Outline {
+        int top, bottom, left, right;
+    };
+
+    std::vector<Outline> buildOutlines(const std::vector<Rect> &rects, const Layout &layout) {
+        std::vector<Outline> outlines;
+        outlines.reserve(rects.size());
+        for (const Rect &r : rects) {
+            if (r.top < 0 || r.left < 0 || r.bottom >= layout.rows || r.right >= layout.cols || r.top > r.bottom || r.left > r.right) {
+                throw std::invalid_argument("Un rectangulo de zona queda fuera de la matriz de datos.");
+            }
+            Outline o;
+            o.top = r.top == 0 ? 0 : layout.rowEdge(r.top) + layout.margin + kBorderExtension;
+            o.bottom = r.bottom == layout.rows - 1 ? layout.height() - 1 : layout.rowEdge(r.bottom + 1) - layout.margin + kBorderExtension;
+            o.left = r.left == 0 ? 0 : layout.colEdge(r.left) + layout.margin + kBorderExtension;
+            o.right = r.right == layout.cols - 1 ? layout.width() - 1 : layout.colEdge(r.right + 1) - layout.margin + kBorderExtension;
+            if (o.top <= o.bottom && o.left <= o.right) {
+                outlines.push_back(o);
             }
         }
+        std::sort(outlines.begin(), outlines.end(), [](const Outline &a, const Outline &b) { return a.top < b.top; });
+        return outlines;
+    }
 
-        if (!Z.empty()) {
-            if (static_cast<int>(Z.size()) != rows) {
-                throw std::invalid_argument("La matriz de zonas no coincide en filas con la matriz de datos.");
+    // Dibuja (en negro, 1 píxel) la parte de cada contorno que cae en la franja [bandTop, bandTop + band.rows).
+    void drawOutlines(cv::Mat &band, int bandTop, const std::vector<Outline> &outlines) {
+        const int bandBottom = bandTop + band.rows - 1;
+        auto paint = [&](int y, int x) {
+            uchar *px = band.ptr<uchar>(y - bandTop) + 3 * x;
+            px[0] = px[1] = px[2] = 0;
+        };
+        for (const Outline &o : outlines) {
+            if (o.top > bandBottom) {
+                break; // ordenados por 'top': los siguientes empiezan más abajo
             }
-            for (const auto &row : Z) {
-                if (static_cast<int>(row.size()) != cols) {
-                    throw std::invalid_argument("La matriz de zonas no coincide en columnas con la matriz de datos.");
+            if (o.bottom < bandTop) {
+                continue;
+            }
+            for (int y : {o.top, o.bottom}) {
+                if (y >= bandTop && y <= bandBottom) {
+                    for (int x = o.left; x <= o.right; ++x) {
+                        paint(y, x);
+                    }
                 }
             }
+            for (int y = std::max(o.top, bandTop); y <= std::min(o.bottom, bandBottom); ++y) {
+                paint(y, o.left);
+                paint(y, o.right);
+            }
         }
+    }
 
-        cv::Mat matM(rows, cols, CV_32F);
-        
-        for(int i = 0; i < rows; ++i) {
-            for(int j = 0; j < cols; ++j) {
-                matM.at<float>(i,j) = M[i][j];
-            }
+    template <typename T>
+    constexpr int matType() { return std::is_same<T, float>::value ? CV_32F : CV_64F; }
+
+    // Filas de salida [y0, y1) escaladas por 'factor' con interpolación cúbica. Se escala solo
+    // el tramo de M que las cubre, con kCubicHalo filas extra a cada lado, así el resultado
+    // coincide con el de escalar la matriz completa.
+    template <typename T>
+    cv::Mat upscaleRows(const Grid<T> &M, const Layout &layout, int y0, int y1) {
+        const int f = layout.factor;
+        const int r0 = y0 / f;
+        const int r1 = (y1 + f - 1) / f;
+        const int s0 = std::max(0, r0 - kCubicHalo);
+        const int s1 = std::min(layout.rows, r1 + kCubicHalo);
+
+        // Grid es contigua por filas: OpenCV la usa directamente, sin copiar (solo lectura).
+        const cv::Mat src(s1 - s0, layout.cols, matType<T>(), const_cast<T *>(M[s0]), M.stride() * sizeof(T));
+        if (f == 1) {
+            return src(cv::Rect(0, y0 - s0, layout.cols, y1 - y0));
         }
-        
-        cv::Mat matZ;
-        if (!Z.empty()) {
-            matZ = cv::Mat(rows, cols, CV_32S);
-            for(int i = 0; i < rows; ++i) {
-                for(int j = 0; j < cols; ++j) {
-                    matZ.at<int>(i,j) = Z[i][j];
+        cv::Mat big;
+        cv::resize(src, big, cv::Size(layout.cols * f, (s1 - s0) * f), 0, 0, cv::INTER_CUBIC);
+        return big(cv::Rect(0, y0 - s0 * f, layout.outCols, y1 - y0));
+    }
+
+    // Filas de salida [y0, y1) de la vista previa: cada píxel es la media de su bloque de celdas.
+    template <typename T>
+    cv::Mat averageBlocks(const Grid<T> &M, const Layout &layout, int y0, int y1, std::vector<double> &acc) {
+        const int b = layout.block;
+        cv::Mat values(y1 - y0, layout.outCols, CV_64F);
+        acc.assign(layout.outCols, 0.0);
+        for (int y = y0; y < y1; ++y) {
+            std::fill(acc.begin(), acc.end(), 0.0);
+            const int sr0 = y * b;
+            const int sr1 = std::min(layout.rows, sr0 + b);
+            for (int r = sr0; r < sr1; ++r) {
+                const T *row = M[r];
+                for (int c = 0; c < layout.cols; ++c) {
+                    acc[c / b] += row[c];
                 }
             }
+            double *out = values.ptr<double>(y - y0);
+            for (int x = 0; x < layout.outCols; ++x) {
+                const int blockCols = std::min(b, layout.cols - x * b);
+                out[x] = acc[x] / (static_cast<double>(sr1 - sr0) * blockCols);
+            }
         }
-        
-        cv::Mat M_big;
-        cv::resize(matM, M_big, cv::Size(), factor, factor, cv::INTER_CUBIC);
-
-        cv::Mat Mnorm, heatmap;
-        cv::normalize(M_big, Mnorm, 0, 255, cv::NORM_MINMAX, CV_8U);
-        cv::applyColorMap(Mnorm, heatmap, cv::COLORMAP_VIRIDIS);
-
-        if (!matZ.empty()) {
-            cv::Mat heatmapRGBA;
-            cv::cvtColor(heatmap, heatmapRGBA, cv::COLOR_BGR2BGRA);
-            
-            cv::Mat Z_big;
-            cv::resize(matZ, Z_big, cv::Size(), factor, factor, cv::INTER_NEAREST);
-
-            int borderExtension = 2;
-            cv::Mat expandedHeatmap;
-            cv::copyMakeBorder(heatmapRGBA, expandedHeatmap, borderExtension, borderExtension, 
-                              borderExtension, borderExtension, cv::BORDER_CONSTANT, cv::Scalar(255,255,255,255));
-
-            std::vector<int> uniqueZones;
-            for(int i = 0; i < matZ.rows; ++i) {
-                for(int j = 0; j < matZ.cols; ++j) {
-                    int zone = matZ.at<int>(i,j);
-                    if(std::find(uniqueZones.begin(), uniqueZones.end(), zone) == uniqueZones.end()) {
-                        uniqueZones.push_back(zone);
-                    }
-                }
+        return values;
+    }
+
+    // Destino de las franjas, en orden de arriba hacia abajo.
+    class BandSink {
+    public:
+        virtual ~BandSink() = default;
+        virtual void write(const cv::Mat &band) = 0;
+    };
+
+    // Arma la imagen completa (para PNG y otros formatos de OpenCV, o para mostrarla).
+    class MatSink : public BandSink {
+    public:
+        MatSink(int height, int width) : image(height, width, CV_8UC3) {}
+        void write(const cv::Mat &band) override {
+            band.copyTo(image.rowRange(next, next + band.rows));
+            next += band.rows;
+        }
+        cv::Mat image;
+
+    private:
+        int next = 0;
+    };
+
+    // PPM binario (P6) escrito franja a franja: la imagen nunca está entera en memoria.
+    class PpmSink : public BandSink {
+    public:
+        PpmSink(const std::string &path, int height, int width) : path(path), out(path, std::ios::binary) {
+            if (!out) {
+                throw std::runtime_error("No se pudo escribir la imagen en " + path);
+            }
+            out << "P6\n" << width << ' ' << height << "\n255\n";
+        }
+        void write(const cv::Mat &band) override {
+            cv::cvtColor(band, rgb, cv::COLOR_BGR2RGB);
+            for (int y = 0; y < rgb.rows; ++y) {
+                out.write(reinterpret_cast<const char *>(rgb.ptr<uchar>(y)), static_cast<std::streamsize>(rgb.cols) * 3);
+            }
+            if (!out) {
+                throw std::runtime_error("No se pudo escribir la imagen en " + path);
+            }
+        }
+
+    private:
+        std::string path;
+        std::ofstream out;
+        cv::Mat rgb;
+    };
+
+    template <typename T>
+    void renderBands(const Grid<T> &M, const std::vector<Rect> &rects, const Layout &layout, int bandRows, BandSink &sink) {
+        // Rango global de M: la normalización no puede depender de la franja.
+        double lo = M[0][0], hi = M[0][0];
+        for (int i = 0; i < M.rows(); ++i) {
+            const T *row = M[i];
+            for (int j = 0; j < M.cols(); ++j) {
+                lo = std::min<double>(lo, row[j]);
+                hi = std::max<double>(hi, row[j]);
+            }
+        }
+        const double scale = hi > lo ? 255.0 / (hi - lo) : 0.0;
+
+        const std::vector<Outline> outlines = buildOutlines(rects, layout);
+        std::vector<double> acc;
+        bandRows = std::max(1, bandRows);
+
+        for (int bandTop = 0; bandTop < layout.height(); bandTop += bandRows) {
+            const int n = std::min(bandRows, layout.height() - bandTop);
+            cv::Mat band(n, layout.width(), CV_8UC3, cv::Scalar(255, 255, 255));
+
+            // Filas de contenido (sin marco) que caen en la franja.
+            const int y0 = std::max(bandTop, kBorderExtension) - kBorderExtension;
+            const int y1 = std::min(bandTop + n, kBorderExtension + layout.outRows) - kBorderExtension;
+            if (y1 > y0) {
+                const cv::Mat values = layout.block > 1 ? averageBlocks(M, layout, y0, y1, acc) : upscaleRows(M, layout, y0, y1);
+                cv::Mat gray, colored;
+                values.convertTo(gray, CV_8U, scale, -lo * scale);
+                cv::applyColorMap(gray, colored, cv::COLORMAP_VIRIDIS);
+                colored.copyTo(band(cv::Rect(kBorderExtension, y0 + kBorderExtension - bandTop, layout.outCols, y1 - y0)));
             }
 
-            for(int zone : uniqueZones) {
-                int minRow = matZ.rows, maxRow = -1, minCol = matZ.cols, maxCol = -1;
-                
-                for(int i = 0; i < matZ.rows; ++i) {
-                    for(int j = 0; j < matZ.cols; ++j) {
-                        if(matZ.at<int>(i,j) == zone) {
-                            minRow = std::min(minRow, i);
-                            maxRow = std::max(maxRow, i);
-                            minCol = std::min(minCol, j);
-                            maxCol = std::max(maxCol, j);
-                        }
+            drawOutlines(band, bandTop, outlines);
+            sink.write(band);
+        }
+    }
+
+    // Rectángulo envolvente de cada etiqueta de Z, en un único recorrido.
+    std::vector<Rect> zoneRects(const Grid<int> &Z) {
+        std::vector<Rect> rects;
+        std::unordered_map<int, size_t> index;
+        int lastZone = 0;
+        size_t last = 0;
+        for (int i = 0; i < Z.rows(); ++i) {
+            const int *row = Z[i];
+            for (int j = 0; j < Z.cols(); ++j) {
+                if (rects.empty() || row[j] != lastZone) {
+                    lastZone = row[j];
+                    auto it = index.find(lastZone);
+                    if (it == index.end()) {
+                        it = index.emplace(lastZone, rects.size()).first;
+                        rects.push_back(Rect{i, i, j, j});
                     }
+                    last = it->second;
                 }
-                
-                bool touchesTop = (minRow == 0);
-                bool touchesBottom = (maxRow == matZ.rows - 1);
-                bool touchesLeft = (minCol == 0);
-                bool touchesRight = (maxCol == matZ.cols - 1);
-                
-                int margin = 2;
-                int topY = minRow * factor + (touchesTop ? -borderExtension : margin) + borderExtension;
-                int bottomY = (maxRow + 1) * factor - (touchesBottom ? -margin : margin) + borderExtension;
-                int leftX = minCol * factor + (touchesLeft ? -borderExtension : margin) + borderExtension;
-                int rightX = (maxCol + 1) * factor - (touchesRight ? -margin : margin) + borderExtension;
-                
-                if (touchesBottom) bottomY = std::min(bottomY + borderExtension, expandedHeatmap.rows - 1);
-                if (touchesRight) rightX = std::min(rightX + borderExtension, expandedHeatmap.cols - 1);
-                
-                cv::Point topLeft(leftX, topY);
-                cv::Point bottomRight(rightX, bottomY);
-                
-                cv::rectangle(expandedHeatmap, topLeft, bottomRight, cv::Scalar(0,0,0,255), 1);
-            }
-            
-            cv::cvtColor(expandedHeatmap, heatmap, cv::COLOR_BGRA2BGR);
-        }
-
-        return heatmap;
+                Rect &r = rects[last];
+                r.top = std::min(r.top, i);
+                r.bottom = std::max(r.bottom, i);
+                r.left = std::min(r.left, j);
+                r.right = std::max(r.right, j);
+            }
+        }
+        return rects;
+    }
+
+    void checkInputs(const Grid<float> &M, const Grid<int> &Z) {
+        if (M.empty()) {
+            throw std::invalid_argument("La matriz de datos no puede estar vacia.");
+        }
+        if (!Z.empty()) {
+            if (Z.rows() != M.rows()) {
+                throw std::invalid_argument("La matriz de zonas no coincide en filas con la matriz de datos.");
+            }
+            if (Z.cols() != M.cols()) {
+                throw std::invalid_argument("La matriz de zonas no coincide en columnas con la matriz de datos.");
+            }
+        }
+    }
+
+    bool isStreamableFormat(const std::string &path) {
+        std::string ext = std::filesystem::path(path).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+        return ext == ".ppm" || ext == ".pnm";
+    }
+
+    template <typename T>
+    void saveHeatmapImpl(const Grid<T> &M, const std::vector<Rect> &rects, const std::string &outputPath, const HeatmapOptions &options) {
+        if (M.empty()) {
+            throw std::invalid_argument("La matriz de datos no puede estar vacia.");
+        }
+        const Layout layout = makeLayout(M.rows(), M.cols(), options);
+
+        if (isStreamableFormat(outputPath)) {
+            PpmSink sink(outputPath, layout.height(), layout.width());
+            renderBands(M, rects, layout, options.bandRows, sink);
+            return;
+        }
+
+        MatSink sink(layout.height(), layout.width());
+        renderBands(M, rects, layout, options.bandRows, sink);
+        if (!cv::imwrite(outputPath, sink.image)) {
+            throw std::runtime_error("No se pudo escribir la imagen en " + outputPath);
+        }
     }
 }
 
-void plotHeatmap(const std::vector<std::vector<float>>& M, int factor, const std::vector<std::vector<int>>& Z) {
-    cv::Mat heatmap = buildHeatmapImage(M, factor, Z);
+void plotHeatmap(const Grid<float>& M, int factor, const Grid<int>& Z) {
+    checkInputs(M, Z);
+    HeatmapOptions options;
+    options.factor = factor;
+    const Layout layout = makeLayout(M.rows(), M.cols(), options);
+    MatSink sink(layout.height(), layout.width());
+    renderBands(M, Z.empty() ? std::vector<Rect>() : zoneRects(Z), layout, options.bandRows, sink);
+
     std::string windowTitle = !Z.empty() ? "Mapa de Calor con Zonas" : "Mapa de Calor";
-    cv::imshow(windowTitle, heatmap);
+    cv::imshow(windowTitle, sink.image);
     cv::waitKey(0);
 }
 
-void saveHeatmap(const std::vector<std::vector<float>>& M, int factor, const std::vector<std::vector<int>>& Z, const std::string &outputPath) {
-    cv::Mat heatmap = buildHeatmapImage(M, factor, Z);
-    if (!cv::imwrite(outputPath, heatmap)) {
-        throw std::runtime_error("No se pudo escribir la imagen en " + outputPath);
-    }
+void saveHeatmap(const Grid<float>& M, int factor, const Grid<int>& Z, const std::string &outputPath) {
+    checkInputs(M, Z);
+    HeatmapOptions options;
+    options.factor = factor;
+    saveHeatmapImpl(M, Z.empty() ? std::vector<Rect>() : zoneRects(Z), outputPath, options);
+}
+
+void saveHeatmap(const Grid<double> &M, const std::vector<Rect> &rects, const std::string &outputPath, const HeatmapOptions &options) {
+    saveHeatmapImpl(M, rects, outputPath, options);
+}
+
+void saveHeatmap(const Grid<float> &M, const std::vector<Rect> &rects, const std::string &outputPath, const HeatmapOptions &options) {
+    saveHeatmapImpl(M, rects, outputPath, options);
 }
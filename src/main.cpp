@@ -5,29 +5,19 @@
 #include <utility>
 #include <vector>
 
+#include "Batch.hpp"
 #include "IO.hpp"
-#include "SA.hpp"
+#include "OutputQueue.hpp"
+#include "Random.hpp"
+#include "RunOptions.hpp"
+#include "Solver.hpp"
 #include "Heatmap.hpp"
 
 namespace
 {
-    std::vector<std::vector<float>> toFloatMatrix(const std::vector<std::vector<double>> &matrix)
+    std::string heatmapPathFor(const std::string &bestPath, const RunOptions &opts)
     {
-        std::vector<std::vector<float>> result;
-        result.reserve(matrix.size());
-
-        for (const auto &row : matrix)
-        {
-            std::vector<float> floatRow;
-            floatRow.reserve(row.size());
-            for (double value : row)
-            {
-                floatRow.push_back(static_cast<float>(value));
-            }
-            result.push_back(std::move(floatRow));
-        }
-
-        return result;
+        return bestPath + "." + opts.heatmapFormat;
     }
 
     int chooseScaleFactor(int rows, int cols)
@@ -47,70 +37,151 @@ namespace
         }
         return 25;
     }
+
+    // Heatmap del mejor resultado junto al .out: {bestPath}.{png|ppm}
+    void renderHeatmap(const ProblemInstance &instance, const std::vector<Rect> &rects, const std::string &bestPath, const RunOptions &opts)
+    {
+        HeatmapOptions options;
+        options.factor = chooseScaleFactor(instance.nRows, instance.nCols);
+        options.maxOutputDim = opts.heatmapMaxDim;
+        const std::string heatmapPath = heatmapPathFor(bestPath, opts);
+        std::filesystem::create_directories(std::filesystem::path(heatmapPath).parent_path());
+        saveHeatmap(instance.S, rects, heatmapPath, options);
+    }
+
+    // Etapa de salida: dos hilos (escritura de archivos y render del heatmap en paralelo) y
+    // una cola corta, suficiente para que los solvers no esperen a la E/S.
+    constexpr int kOutputThreads = 2;
+    constexpr std::size_t kOutputQueueCapacity = 8;
 }
 
 int main(int argc, char *argv[])
 {
     try
     {
-        const std::string defaultInstancePath = "data/instances/instance.spp";
-        const std::string configPath = "data/config/default.json";
+        RunOptions opts = parseCommandLine(argc, argv);
+        if (opts.showHelp)
+        {
+            printUsage(std::cout, argv[0]);
+            return 0;
+        }
+
+        SAConfig saCfg = IO::readConfigFromJson(opts.configPath);
+        IO::readRunOptionsFromJson(opts.configPath, opts);
+        applyCommandLineOverrides(opts, saCfg);
+
+        // Sin semilla fija se sortea una sola vez, para poder registrarla y repetir la ejecución.
+        if (saCfg.seed == 0)
+        {
+            saCfg.seed = randomSeed();
+        }
 
-        std::string instancePath = defaultInstancePath;
-        if (argc >= 2)
+        // Modo batch: p y alpha vienen del manifiesto
+        if (!opts.batchManifest.empty())
         {
-            // Permitir pasar solo el nombre, el nombre con extension o una ruta completa.
-            std::string argPath = argv[1];
-            if (argPath.find_first_of("/\\") == std::string::npos)
+            OutputQueue output(kOutputThreads, kOutputQueueCapacity);
+            const auto jobs = readBatchManifest(opts.batchManifest);
+            const auto results = runBatch(jobs, saCfg, opts.outputDir, &output,
+                                          [&opts](const ProblemInstance &instance, const std::vector<Rect> &rects, const std::string &bestPath)
+                                          { renderHeatmap(instance, rects, bestPath, opts); });
+
+            std::cout << "instancia, p, alpha -> energia (carga s / resolucion s)\n";
+            for (const BatchResult &r : results)
             {
-                if (argPath.find('.') == std::string::npos)
+                std::cout << " - " << r.outputName << " -> ";
+                if (r.error.empty())
                 {
-                    argPath += ".spp";
+                    std::cout << r.energy << " (" << r.loadSeconds << " / " << r.solveSeconds << ")\n";
+                }
+                else
+                {
+                    std::cout << "error: " << r.error << '\n';
                 }
-                instancePath = "data/instances/" + argPath;
-            }
-            else
-            {
-                instancePath = std::move(argPath);
             }
+            std::cout << "Resumen: " << (std::filesystem::path(opts.outputDir) / "summary.csv").string() << '\n';
+            return 0;
         }
 
+        const std::string instancePath = opts.instancePath.empty() ? "data/instances/instance.spp" : IO::resolveInstancePath(opts.instancePath);
         const std::string instanceName = std::filesystem::path(instancePath).stem().string();
 
-        // 1) Leer archivo de instancia
+        // 1) Leer archivo de instancia (.spp de texto o .sppb binario)
         ProblemInstance instance = IO::readInstanceFromFile(instancePath);
 
-        // 2) Leer p y alpha por consola
+        // Conversión a .sppb: no se resuelve la instancia
+        if (!opts.convertTo.empty())
+        {
+            IO::writeBinaryInstanceToFile(opts.convertTo, instance, opts.dtype == "float32" ? IO::SppbDtype::Float32 : IO::SppbDtype::Float64);
+            std::cout << "Instancia convertida: " << opts.convertTo << '\n';
+            return 0;
+        }
+
+        // 2) p y alpha: línea de comandos, JSON o, si faltan, consola
+        instance.p = opts.p;
+        instance.alpha = opts.alpha;
         IO::readParamsFromConsole(instance);
 
-        // 3) Simulated Annealing
-        SAConfig saCfg = IO::readConfigFromJson(configPath);
+        // 3) Simulated Annealing (o programación dinámica exacta con mode "dp")
         Solution initial;
-        Solution best = simulatedAnnealing(instance, saCfg, &initial);
+        std::vector<SAStats> chainStats;
+        DPStats dpStats;
+        Solution best = solveInstance(instance, saCfg, &chainStats, &initial, &dpStats);
 
-        // 4) Escribir archivos de salida (antes y después de SA)
-        std::string initialPath = "data/solutions/" + instanceName + "_initial.out";
-        std::string bestPath = "data/solutions/" + instanceName + "_best.out";
-        IO::writeSolutionToFile(initialPath, initial.errorTotal, instance, initial.Z);
-        IO::writeSolutionToFile(bestPath, best.errorTotal, instance, best.Z);
+        // 4) Escribir archivos de salida (antes y después de SA) en la etapa de salida;
+        //    el heatmap se renderiza en paralelo con la escritura de los .out.
+        std::filesystem::create_directories(opts.outputDir);
+        std::string initialPath = (std::filesystem::path(opts.outputDir) / (instanceName + "_initial.out")).string();
+        std::string bestPath = (std::filesystem::path(opts.outputDir) / (instanceName + "_best.out")).string();
+        std::string statsPath = (std::filesystem::path(opts.outputDir) / (instanceName + "_best.stats.json")).string();
+        // Declarada después de los datos que usan sus tareas: ante un error, el destructor
+        // vacía la cola y une los hilos antes de que esos datos se destruyan.
+        OutputQueue output(kOutputThreads, kOutputQueueCapacity);
+        output.submit([&]
+                      { IO::writeSolutionToFile(initialPath, initial.errorTotal, instance, buildLabelGrid(instance, initial.rects), saCfg.seed); });
+        output.submit([&]
+                      { IO::writeSolutionToFile(bestPath, best.errorTotal, instance, buildLabelGrid(instance, best.rects), saCfg.seed); });
+        output.submit([&]
+                      { IO::writeStatsToJson(statsPath, chainStats, saCfg); });
 
         std::string heatmapPath;
-        if (!best.Z.empty())
+        if (!best.rects.empty())
         {
-            const auto dataAsFloat = toFloatMatrix(instance.S);
-            const int scaleFactor = chooseScaleFactor(instance.nRows, instance.nCols);
-            heatmapPath = bestPath + ".png";
-            std::filesystem::create_directories(std::filesystem::path(heatmapPath).parent_path());
-            saveHeatmap(dataAsFloat, scaleFactor, best.Z, heatmapPath);
+            heatmapPath = heatmapPathFor(bestPath, opts);
+            output.submit([&]
+                          { renderHeatmap(instance, best.rects, bestPath, opts); });
         }
+        output.flush();
 
+        std::cout << "Semilla: " << saCfg.seed << '\n';
         std::cout << "Archivos de salida generados:\n"
                   << " - " << initialPath << '\n'
-                  << " - " << bestPath << '\n';
+                  << " - " << bestPath << '\n'
+                  << " - " << statsPath << '\n';
         if (!heatmapPath.empty())
         {
             std::cout << " - " << heatmapPath << '\n';
         }
+
+        if (saCfg.mode == "dp")
+        {
+            std::cout << "Programacion dinamica (paso de corte " << dpStats.cutStride << (dpStats.cutStride == 1 ? ", optimo exacto" : "")
+                      << "): energia " << dpStats.energy << ", " << dpStats.rects << " rectangulos, " << dpStats.states
+                      << " estados, " << dpStats.transitions << " transiciones, tiempo " << dpStats.elapsedSeconds << " s\n";
+        }
+        else if (chainStats.size() > 1)
+        {
+            std::cout << (saCfg.mode == "tempering" ? "Replicas (de la mas fria a la mas caliente al inicio):\n"
+                          : saCfg.mode == "islands" ? "Islas:\n"
+                                                    : "Cadenas de SA:\n");
+            for (size_t c = 0; c < chainStats.size(); ++c)
+            {
+                const SAStats &st = chainStats[c];
+                std::cout << " - #" << c << ": energia " << st.bestEnergy
+                          << ", iteraciones " << st.iterations
+                          << ", aceptados " << st.accepted
+                          << ", tiempo " << st.elapsedSeconds << " s\n";
+            }
+        }
     }
     catch (const std::exception &ex)
     {